@@ -0,0 +1,561 @@
+/***   Microbenchmarks do carregamento e das colisões do Visualizador 3D   ***/
+
+/*** Mede, função por função, os caminhos que dominam o tempo de carga e o custo das colisões:
+     leitura do OBJ e do MTL, triangulação das faces, montagem dos vértices dos grupos e dos buffers da
+     malha, bounding box, caixa transformada dos objetos, teste de raio contra a malha, broad phase (AABBTree)
+     e os núcleos SIMD das colisões (CollisionKernels) em cada nível suportado pela CPU.
+     Cada medida tem aquecimento, várias repetições (mediana, média, desvio, mínimo e máximo por chamada)
+     e o número de alocações por chamada, com os modelos de models/ e entradas sintéticas.
+     Executável separado do visualizador: não cria janela nem contexto OpenGL (ver tasks.json)
+***/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <filesystem>
+#include "OBJReader.h"
+#include "SceneGenerator.h"
+#include "Face.h"
+#include "Group.h"
+#include "Mesh.h"
+#include "Object3D.h"
+#include "AABBTree.h"
+#include "CollisionKernels.h"
+
+using namespace std;
+using namespace glm;
+
+// Contagem de alocações: operator new global substituído neste executável
+// (só as alocações com o alinhamento padrão; as de tipos alinhados, como RayPacket, não passam por aqui)
+static atomic<size_t> totalAlocacoes(0);
+static atomic<size_t> totalBytes(0);
+
+// (o GCC confunde o free abaixo com a liberação de um new da biblioteca padrão)
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size) {
+    totalAlocacoes.fetch_add(1, memory_order_relaxed);
+    totalBytes.fetch_add(size, memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p) throw bad_alloc();
+    return p;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// Resultados que o compilador não pode descartar
+static volatile float sumidouro = 0.0f;
+
+
+struct Opcoes {
+    string filtro;          // só as medidas cujo nome contém o texto
+    int repeticoes;         // amostras medidas
+    int aquecimento;        // amostras descartadas antes das medidas
+    double tempoMinimoMs;   // duração mínima de uma amostra (as funções rápidas são repetidas dentro dela)
+    string diretorioModelos;
+    string relatorioJSON;   // vazio = só a tabela no console
+
+    Opcoes() : repeticoes(20), aquecimento(3), tempoMinimoMs(5.0), diretorioModelos("models") {}
+};
+
+struct Resultado {
+    string nome;
+    int repeticoes;
+    size_t chamadasPorAmostra;
+    double medianaNs, mediaNs, desvioNs, minimoNs, maximoNs;   // por chamada
+    double alocacoes, bytes;                                    // por chamada
+};
+
+
+// Executa "executar" em amostras e resume o tempo por chamada
+// Sem "preparar", cada amostra repete a função até durar tempoMinimoMs (calibrado antes das amostras);
+// com "preparar", a preparação roda antes de cada chamada, fora da medição e da contagem de alocações
+static Resultado medir(const string& nome, const function<void()>& preparar, const function<void()>& executar,
+                       const Opcoes& opcoes) {
+    typedef chrono::steady_clock Relogio;
+
+    size_t chamadas = 1;
+    if (!preparar) {
+        while (true) {
+            auto inicio = Relogio::now();
+            for (size_t i = 0; i < chamadas; i++) { executar(); }
+            double ms = chrono::duration<double, milli>(Relogio::now() - inicio).count();
+            if (ms >= opcoes.tempoMinimoMs || chamadas >= ((size_t)1 << 30)) break;
+            size_t estimativa = ms > 0.0 ? (size_t)(chamadas * opcoes.tempoMinimoMs / ms * 1.2) : chamadas * 10;
+            chamadas = std::max(chamadas * 2, estimativa);
+        }
+    }
+
+    vector<double> amostras;
+    size_t alocacoes = 0, bytes = 0;
+    for (int amostra = 0; amostra < opcoes.aquecimento + opcoes.repeticoes; amostra++) {
+        double ns = 0.0;
+        size_t alocacoesAntes = 0, bytesAntes = 0, alocacoesAmostra = 0, bytesAmostra = 0;
+
+        if (!preparar) {
+            alocacoesAntes = totalAlocacoes.load();
+            bytesAntes = totalBytes.load();
+            auto inicio = Relogio::now();
+            for (size_t i = 0; i < chamadas; i++) { executar(); }
+            ns = chrono::duration<double, nano>(Relogio::now() - inicio).count();
+            alocacoesAmostra = totalAlocacoes.load() - alocacoesAntes;
+            bytesAmostra = totalBytes.load() - bytesAntes;
+        } else {
+            preparar();
+            alocacoesAntes = totalAlocacoes.load();
+            bytesAntes = totalBytes.load();
+            auto inicio = Relogio::now();
+            executar();
+            ns = chrono::duration<double, nano>(Relogio::now() - inicio).count();
+            alocacoesAmostra = totalAlocacoes.load() - alocacoesAntes;
+            bytesAmostra = totalBytes.load() - bytesAntes;
+        }
+
+        if (amostra < opcoes.aquecimento) continue;
+        amostras.push_back(ns / chamadas);
+        alocacoes += alocacoesAmostra;
+        bytes += bytesAmostra;
+    }
+
+    Resultado resultado;
+    resultado.nome = nome;
+    resultado.repeticoes = opcoes.repeticoes;
+    resultado.chamadasPorAmostra = chamadas;
+
+    double soma = 0.0;
+    for (double ns : amostras) { soma += ns; }
+    resultado.mediaNs = soma / amostras.size();
+
+    double variancia = 0.0;
+    for (double ns : amostras) { variancia += (ns - resultado.mediaNs) * (ns - resultado.mediaNs); }
+    resultado.desvioNs = amostras.size() > 1 ? sqrt(variancia / (amostras.size() - 1)) : 0.0;
+
+    sort(amostras.begin(), amostras.end());
+    resultado.minimoNs = amostras.front();
+    resultado.maximoNs = amostras.back();
+    resultado.medianaNs = amostras.size() % 2 ? amostras[amostras.size() / 2]
+                                              : (amostras[amostras.size() / 2 - 1] + amostras[amostras.size() / 2]) / 2.0;
+
+    double totalChamadas = (double)chamadas * opcoes.repeticoes;
+    resultado.alocacoes = alocacoes / totalChamadas;
+    resultado.bytes = bytes / totalChamadas;
+    return resultado;
+}
+
+
+// Duração legível (ns, us ou ms)
+static string formatarTempo(double ns) {
+    ostringstream texto;
+    texto << fixed << setprecision(ns < 10.0 ? 2 : 1);
+    if (ns < 1.0e3)      { texto << ns << " ns"; }
+    else if (ns < 1.0e6) { texto << ns / 1.0e3 << " us"; }
+    else                 { texto << ns / 1.0e6 << " ms"; }
+    return texto.str();
+}
+
+
+static void imprimir(const Resultado& r) {
+    cout << left << setw(60) << r.nome << right
+         << setw(12) << formatarTempo(r.medianaNs)
+         << setw(12) << formatarTempo(r.mediaNs)
+         << setw(8) << fixed << setprecision(1) << (r.mediaNs > 0.0 ? 100.0 * r.desvioNs / r.mediaNs : 0.0) << "%"
+         << setw(12) << formatarTempo(r.minimoNs)
+         << setw(12) << formatarTempo(r.maximoNs)
+         << setw(12) << setprecision(1) << r.alocacoes
+         << setw(14) << setprecision(0) << r.bytes << endl;
+}
+
+
+static bool gravarJSON(const string& caminho, const vector<Resultado>& resultados) {
+    ofstream arquivo(caminho);
+    if (!arquivo.is_open()) {
+        cerr << "Falha ao criar relatorio: " << caminho << endl;
+        return false;
+    }
+
+    arquivo << setprecision(9) << "[" << endl;
+    for (size_t i = 0; i < resultados.size(); i++) {
+        const Resultado& r = resultados[i];
+        arquivo << "  {\"name\": \"" << r.nome << "\", \"repetitions\": " << r.repeticoes
+                << ", \"callsPerSample\": " << r.chamadasPorAmostra
+                << ", \"medianNs\": " << r.medianaNs << ", \"meanNs\": " << r.mediaNs << ", \"stddevNs\": " << r.desvioNs
+                << ", \"minNs\": " << r.minimoNs << ", \"maxNs\": " << r.maximoNs
+                << ", \"allocsPerCall\": " << r.alocacoes << ", \"bytesPerCall\": " << r.bytes << "}"
+                << (i + 1 < resultados.size() ? "," : "") << endl;
+    }
+    arquivo << "]" << endl;
+    return true;
+}
+
+
+// Entrada sintética: MTL com "quantidade" materiais completos
+static bool gerarMTL(const string& caminho, int quantidade) {
+    ofstream mtl(caminho);
+    if (!mtl.is_open()) return false;
+
+    for (int i = 0; i < quantidade; i++) {
+        mtl << "newmtl material" << i << "\n"
+            << "Ka 0.2 0.2 0.2\nKd 0.8 " << (i % 10) / 10.0f << " 0.3\nKs 0.5 0.5 0.5\nNs 32\nd 1.0\nillum 2\n"
+            << "map_Kd textura" << i << ".png\n\n";
+    }
+    return true;
+}
+
+
+// Modelo lido uma vez e compartilhado pelas medidas que partem de dados já carregados
+struct Modelo {
+    string nome;
+    string caminhoOBJ;
+    vector<vec3> vertices;
+    vector<vec2> texCoords;
+    vector<vec3> normals;
+    vector<Group> grupos;           // como lidos do OBJ (faces já trianguladas)
+    vector<Group> gruposMontados;   // depois de Group::buildVertexData
+    shared_ptr<Mesh> malha;         // vertexData/indexData, bounding box e BVH (testes de raio)
+};
+
+
+static bool carregarModelo(const string& nome, const string& caminho, Modelo& modelo) {
+    modelo.nome = nome;
+    modelo.caminhoOBJ = caminho;
+
+    map<string, Material> materiais;
+    if (!OBJReader::readFileOBJ(caminho, modelo.vertices, modelo.texCoords, modelo.normals,
+                                modelo.grupos, materiais, 1)) {
+        return false;
+    }
+
+    modelo.gruposMontados = modelo.grupos;
+    for (Group& grupo : modelo.gruposMontados) {
+        grupo.buildVertexData(modelo.vertices, modelo.texCoords, modelo.normals);
+    }
+
+    modelo.malha = make_shared<Mesh>();
+    modelo.malha->vertices = modelo.vertices;
+    modelo.malha->groups = modelo.gruposMontados;
+    modelo.malha->setupBuffers();
+    modelo.malha->calculateBoundingBox();
+    modelo.malha->buildBVH();
+    return true;
+}
+
+
+static void imprimirUso() {
+    cout << "Uso: microbench [--filter texto] [--reps N] [--warmup N] [--min-time ms] [--models diretorio] [--json arquivo]" << endl;
+}
+
+
+int main(int argc, char* argv[]) {
+    Opcoes opcoes;
+    for (int i = 1; i < argc; i++) {
+        string opcao = argv[i];
+        if (i + 1 >= argc) { imprimirUso(); return EXIT_FAILURE; }
+        string valor = argv[++i];
+
+        if      (opcao == "--filter")   { opcoes.filtro = valor; }
+        else if (opcao == "--reps")     { opcoes.repeticoes = std::max(1, atoi(valor.c_str())); }
+        else if (opcao == "--warmup")   { opcoes.aquecimento = std::max(0, atoi(valor.c_str())); }
+        else if (opcao == "--min-time") { opcoes.tempoMinimoMs = atof(valor.c_str()); }
+        else if (opcao == "--models")   { opcoes.diretorioModelos = valor; }
+        else if (opcao == "--json")     { opcoes.relatorioJSON = valor; }
+        else { imprimirUso(); return EXIT_FAILURE; }
+    }
+
+    // Entradas sintéticas em um diretório temporário relativo ao diretório atual, como os modelos do projeto
+    // (o "mtllib" do OBJ é aberto a partir do diretório atual - ver OBJReader::readFileOBJ)
+    filesystem::path temporario = "microbench_entradas";
+    filesystem::create_directories(temporario);
+    string gradeOBJ = (temporario / "grade.obj").generic_string();
+    string gradeMTL = (temporario / "grade.mtl").generic_string();
+    string muitosMTL = (temporario / "materiais.mtl").generic_string();
+    SceneGenerator::OBJParams grade;    // 300 x 300 quadriláteros com vt e vn, em dois grupos de materiais diferentes
+    grade.vertices = 301 * 301;
+    grade.arity = 4;
+    grade.groups = 2;
+    grade.materials = 2;
+    grade.size = 30.0f;
+    if (!SceneGenerator::writeOBJ(gradeOBJ, gradeMTL, grade) || !gerarMTL(muitosMTL, 512)) {
+        cerr << "Falha ao gravar as entradas sinteticas em " << temporario.string() << endl;
+        return EXIT_FAILURE;
+    }
+
+    // Modelos do projeto e a grade sintética (90 mil quadriláteros)
+    vector<unique_ptr<Modelo>> modelos;
+    vector<pair<string, string>> entradas = {
+        { "car",         opcoes.diretorioModelos + "/car.obj" },
+        { "conversivel", opcoes.diretorioModelos + "/conversivel.obj" },
+        { "pista",       opcoes.diretorioModelos + "/pista.obj" },
+        { "grade300",    gradeOBJ },
+    };
+    for (const auto& entrada : entradas) {
+        unique_ptr<Modelo> modelo(new Modelo());
+        streambuf* console = cout.rdbuf(nullptr);
+        bool carregado = carregarModelo(entrada.first, entrada.second, *modelo);
+        cout.rdbuf(console);
+        if (!carregado) {
+            cerr << "Modelo ignorado (falha ao ler " << entrada.second << ")" << endl;
+            continue;
+        }
+        modelos.push_back(move(modelo));
+    }
+
+    vector<Resultado> resultados;
+    auto executar = [&](const string& nome, function<void()> preparar, function<void()> corpo) {
+        if (!opcoes.filtro.empty() && nome.find(opcoes.filtro) == string::npos) return;
+
+        // As mensagens de progresso do carregamento (cout) são descartadas durante as medidas:
+        // sem buffer, o stream fica em estado de erro e cada << retorna sem formatar nada
+        streambuf* console = cout.rdbuf(nullptr);
+        Resultado resultado = medir(nome, preparar, corpo, opcoes);
+        cout.rdbuf(console);
+
+        resultados.push_back(resultado);
+        imprimir(resultado);
+    };
+
+    cout << left << setw(60) << "medida" << right << setw(12) << "mediana" << setw(12) << "media" << setw(9) << "desvio"
+         << setw(12) << "minimo" << setw(12) << "maximo" << setw(12) << "alocacoes" << setw(14) << "bytes" << endl;
+
+    // OBJReader::readFileOBJ (serial e automático) e readFileMTL
+    for (const auto& modelo : modelos) {
+        for (unsigned int threads : { 1u, 0u }) {
+            string caminho = modelo->caminhoOBJ;
+            executar("OBJReader::readFileOBJ/" + modelo->nome + (threads == 1 ? "/serial" : "/auto"), nullptr, [caminho, threads]() {
+                vector<vec3> vertices, normals;
+                vector<vec2> texCoords;
+                vector<Group> grupos;
+                map<string, Material> materiais;
+                OBJReader::readFileOBJ(caminho, vertices, texCoords, normals, grupos, materiais, threads);
+                sumidouro = sumidouro + (float)grupos.size();
+            });
+        }
+    }
+    for (const string& mtl : { opcoes.diretorioModelos + "/car.mtl", opcoes.diretorioModelos + "/conversivel.mtl", muitosMTL }) {
+        string nome = filesystem::path(mtl).filename().string();
+        executar("OBJReader::readFileMTL/" + nome, nullptr, [mtl]() {
+            map<string, Material> materiais;
+            OBJReader::readFileMTL(mtl, materiais);
+            sumidouro = sumidouro + (float)materiais.size();
+        });
+    }
+
+    // Face::triangulate (vetor novo a cada chamada e acréscimo a um vetor reaproveitado)
+    for (unsigned int lados : { 3u, 4u, 6u, 16u }) {
+        vector<unsigned int> indices;
+        for (unsigned int i = 0; i < lados; i++) { indices.push_back(i + 1); }
+        Face face(indices, indices, indices);
+
+        executar("Face::triangulate/" + to_string(lados) + "-gono", nullptr, [face]() {
+            vector<Face> triangulos = face.triangulate();
+            sumidouro = sumidouro + (float)triangulos.size();
+        });
+
+        auto triangulos = make_shared<vector<Face>>();
+        executar("Face::triangulate(destino)/" + to_string(lados) + "-gono", nullptr, [face, triangulos]() {
+            triangulos->clear();
+            face.triangulate(*triangulos);
+            sumidouro = sumidouro + (float)triangulos->size();
+        });
+    }
+
+    // Montagem dos buffers na CPU: Group::buildVertexData de todos os grupos e Mesh::setupBuffers
+    for (const auto& modelo : modelos) {
+        Modelo* m = modelo.get();
+        auto grupos = make_shared<vector<Group>>();
+        executar("Group::buildVertexData/" + m->nome, [m, grupos]() { *grupos = m->grupos; }, [m, grupos]() {
+            for (Group& grupo : *grupos) { grupo.buildVertexData(m->vertices, m->texCoords, m->normals); }
+        });
+
+        auto malha = make_shared<Mesh>();
+        executar("Mesh::setupBuffers/" + m->nome, [m, malha]() { malha->groups = m->gruposMontados; }, [malha]() {
+            malha->setupBuffers();
+        });
+    }
+
+    // Mesh::calculateBoundingBox
+    for (const auto& modelo : modelos) {
+        auto malha = make_shared<Mesh>();
+        malha->vertices = modelo->vertices;
+        executar("Mesh::calculateBoundingBox/" + modelo->nome, nullptr, [malha]() {
+            malha->calculateBoundingBox();
+            sumidouro = sumidouro + malha->boundingBox.pontoMaximo.x;
+        });
+    }
+
+    // Object3D::getTransformedBoundingBox e Object3D::rayIntersect, com o objeto rotacionado e escalado
+    for (const auto& modelo : modelos) {
+        auto objeto = make_shared<Object3D>();
+        objeto->mesh = modelo->malha;
+        objeto->setPosition(vec3(1.0f, 2.0f, -3.0f));
+        objeto->setRotation(vec3(0.3f, 1.1f, 0.0f));
+        objeto->setScale(vec3(0.5f));
+
+        if (modelo == modelos.front()) {
+            executar("Object3D::getTransformedBoundingBox", nullptr, [objeto]() {
+                BoundingBox caixa = objeto->getTransformedBoundingBox();
+                sumidouro = sumidouro + caixa.pontoMaximo.x;
+            });
+        }
+
+        // Raios em mundo (semente fixa): partem de uma esfera em volta do objeto e apontam para um ponto da
+        // sua caixa (quase sempre atingem a malha) ou para fora dela (descartados pela bounding box)
+        const BoundingBox& caixa = modelo->malha->boundingBox;
+        vec3 centro = (caixa.pontoMinimo + caixa.pontoMaximo) * 0.5f;
+        float raio = length(caixa.pontoMaximo - caixa.pontoMinimo);
+        mt19937 gerador(42);
+        uniform_real_distribution<float> uniforme(0.0f, 1.0f);
+
+        auto origens = make_shared<vector<vec3>>(), acertos = make_shared<vector<vec3>>(), erros = make_shared<vector<vec3>>();
+        for (int i = 0; i < 1024; i++) {
+            vec3 esfera = normalize(vec3(uniforme(gerador), uniforme(gerador), uniforme(gerador)) * 2.0f - 1.0f + 1e-4f);
+            vec3 origem = centro + esfera * raio;
+            vec3 alvo = mix(caixa.pontoMinimo, caixa.pontoMaximo, vec3(uniforme(gerador), uniforme(gerador), uniforme(gerador)));
+
+            vec3 origemMundo = vec3(objeto->transform * vec4(origem, 1.0f));
+            origens->push_back(origemMundo);
+            acertos->push_back(normalize(vec3(objeto->transform * vec4(alvo - origem, 0.0f))));
+            erros->push_back(normalize(vec3(objeto->transform * vec4(origem - centro, 0.0f))));
+        }
+
+        auto proximo = make_shared<size_t>(0);
+        executar("Object3D::rayIntersect/" + modelo->nome + "/acerto", nullptr, [objeto, origens, acertos, proximo, raio]() {
+            size_t i = (*proximo)++ & 1023;
+            RayHit impacto;
+            if (objeto->rayIntersect((*origens)[i], (*acertos)[i], raio * 2.0f, impacto)) { sumidouro = sumidouro + impacto.distance; }
+        });
+        executar("Object3D::rayIntersect/" + modelo->nome + "/erro", nullptr, [objeto, origens, erros, proximo, raio]() {
+            size_t i = (*proximo)++ & 1023;
+            RayHit impacto;
+            if (objeto->rayIntersect((*origens)[i], (*erros)[i], raio * 2.0f, impacto)) { sumidouro = sumidouro + impacto.distance; }
+        });
+    }
+
+    // Broad phase: 1000 objetos (caixas de cerca de 1 unidade, na área das cenas geradas com 1000 objetos)
+    // consultados pelos segmentos de 10 mil projéteis em um passo, um a um (querySegment) e em pacotes de 8
+    // raios (queryPacket, como System::checkCollisions); uma chamada = a consulta de todos os projéteis
+    {
+        mt19937 gerador(7);
+        uniform_real_distribution<float> posicao(-100.0f, 100.0f), tamanho(0.5f, 1.5f), angulo(0.0f, 6.2831853f);
+
+        auto arvore = make_shared<AABBTree>();
+        for (size_t i = 0; i < 1000; i++) {
+            BoundingBox caixa;
+            vec3 centro(posicao(gerador), 1.0f, posicao(gerador));
+            vec3 meio = vec3(tamanho(gerador), tamanho(gerador), tamanho(gerador)) * 0.5f;
+            caixa.pontoMinimo = centro - meio;
+            caixa.pontoMaximo = centro + meio;
+            arvore->insert(caixa, (void*)(i + 1));
+        }
+
+        // Segmentos de 0,5 unidade (o deslocamento de um projétil em um passo) em direções horizontais aleatórias
+        auto inicios = make_shared<vector<vec3>>(), fins = make_shared<vector<vec3>>();
+        auto pacotes = make_shared<vector<RayPacket>>();
+        for (size_t i = 0; i < 10000; i++) {
+            vec3 inicio(posicao(gerador), 1.0f, posicao(gerador));
+            float a = angulo(gerador);
+            vec3 direcao(cos(a), 0.0f, sin(a));
+            inicios->push_back(inicio);
+            fins->push_back(inicio + direcao * 0.5f);
+
+            if (pacotes->empty() || pacotes->back().count == RayPacket::PACKET_SIZE) { pacotes->push_back(RayPacket()); }
+            pacotes->back().add(inicio, direcao, 0.5f);
+        }
+
+        executar("AABBTree::querySegment/1k-objetos/10k-projeteis", nullptr, [arvore, inicios, fins]() {
+            size_t visitadas = 0;
+            for (size_t i = 0; i < inicios->size(); i++) {
+                arvore->querySegment((*inicios)[i], (*fins)[i], [&visitadas](void*) { visitadas++; return true; });
+            }
+            sumidouro = sumidouro + (float)visitadas;
+        });
+
+        for (int nivel = CollisionKernels::SCALAR; nivel <= CollisionKernels::supportedLevel(); nivel++) {
+            CollisionKernels::setLevel((CollisionKernels::Level)nivel);
+            string sufixo = CollisionKernels::levelName((CollisionKernels::Level)nivel);
+            executar("AABBTree::queryPacket/1k-objetos/10k-projeteis/" + sufixo, nullptr, [arvore, pacotes]() {
+                size_t visitadas = 0;
+                for (const RayPacket& pacote : *pacotes) {
+                    arvore->queryPacket(pacote, [&visitadas](void*, unsigned int mask) { visitadas += mask != 0; });
+                }
+                sumidouro = sumidouro + (float)visitadas;
+            });
+        }
+        CollisionKernels::setLevel(CollisionKernels::supportedLevel());
+    }
+
+    // CollisionKernels::raysVsBox (pacote de 8 raios contra uma caixa; metade das caixas no caminho dos raios)
+    // e CollisionKernels::rayVsTriangles (folhas da MeshBVH de 4 triângulos e trechos maiores), em cada nível
+    {
+        mt19937 gerador(11);
+        uniform_real_distribution<float> uniforme(-1.0f, 1.0f);
+
+        auto pacote = make_shared<RayPacket>();
+        for (int i = 0; i < RayPacket::PACKET_SIZE; i++) {
+            pacote->add(vec3(uniforme(gerador), uniforme(gerador), -10.0f),
+                        normalize(vec3(uniforme(gerador) * 0.05f, uniforme(gerador) * 0.05f, 1.0f)), 20.0f);
+        }
+        auto caixas = make_shared<vector<BoundingBox>>(1024);
+        for (size_t i = 0; i < caixas->size(); i++) {
+            vec3 centro(uniforme(gerador) * (i % 2 ? 1.0f : 20.0f), uniforme(gerador) * (i % 2 ? 1.0f : 20.0f), uniforme(gerador) * 5.0f);
+            (*caixas)[i].pontoMinimo = centro - vec3(0.5f);
+            (*caixas)[i].pontoMaximo = centro + vec3(0.5f);
+        }
+
+        // Triângulos espalhados no plano z = 0 em volta do raio, que atravessa alguns deles
+        auto triangulos = make_shared<TriangleSoA>();
+        triangulos->resize(64);
+        for (size_t i = 0; i < 64; i++) {
+            vec3 v0(uniforme(gerador), uniforme(gerador), uniforme(gerador) * 0.1f);
+            triangulos->set(i, v0, v0 + vec3(0.4f, 0.0f, 0.0f), v0 + vec3(0.0f, 0.4f, 0.0f));
+        }
+
+        for (int nivel = CollisionKernels::SCALAR; nivel <= CollisionKernels::supportedLevel(); nivel++) {
+            CollisionKernels::setLevel((CollisionKernels::Level)nivel);
+            string sufixo = CollisionKernels::levelName((CollisionKernels::Level)nivel);
+
+            auto proxima = make_shared<size_t>(0);
+            executar("CollisionKernels::raysVsBox/" + sufixo, nullptr, [pacote, caixas, proxima]() {
+                const BoundingBox& caixa = (*caixas)[(*proxima)++ & 1023];
+                unsigned int mask = CollisionKernels::raysVsBox(*pacote, 0xFF, caixa.pontoMinimo, caixa.pontoMaximo);
+                sumidouro = sumidouro + (float)mask;
+            });
+
+            for (size_t quantidade : { (size_t)4, (size_t)8, (size_t)64 }) {
+                executar("CollisionKernels::rayVsTriangles/" + to_string(quantidade) + "-triangulos/" + sufixo, nullptr,
+                         [triangulos, quantidade]() {
+                    float t = 20.0f, u = 0.0f, v = 0.0f;
+                    long tri = CollisionKernels::rayVsTriangles(*triangulos, 0, quantidade, vec3(0.1f, 0.1f, -10.0f),
+                                                                vec3(0.0f, 0.0f, 1.0f), t, u, v);
+                    sumidouro = sumidouro + t + (float)tri;
+                });
+            }
+        }
+        CollisionKernels::setLevel(CollisionKernels::supportedLevel());
+    }
+
+    if (!opcoes.relatorioJSON.empty() && gravarJSON(opcoes.relatorioJSON, resultados)) {
+        cout << "Relatorio gravado em " << opcoes.relatorioJSON << endl;
+    }
+
+    error_code erro;
+    filesystem::remove_all(temporario, erro);
+    return 0;
+}
@@ -0,0 +1,163 @@
+/***   Gerador de cargas sintéticas do Visualizador 3D   ***/
+
+/*** Gera modelos OBJ/MTL do tamanho e formato pedidos (vértices, lados das faces, grupos, materiais, com ou
+     sem vt/vn) e variantes do Configurador_Cena.txt com N obstáculos, M alvos elimináveis e K veículos
+     animados, para medir como carga, renderização e colisões escalam (ver SceneGenerator).
+     Os arquivos gerados são usados pelo visualizador (--scene, --benchmark) e pelos microbenchmarks.
+     Os caminhos dos modelos na cena e o "mtllib" dos OBJ são relativos ao diretório atual: execute o
+     gerador e o visualizador a partir da raiz do projeto
+***/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <filesystem>
+#include "SceneGenerator.h"
+
+using namespace std;
+
+
+static void imprimirUso() {
+    cout << "Uso:" << endl
+         << "  scenegen obj <saida.obj> [--mtl arquivo] [--vertices N] [--arity K] [--groups G] [--materials M]" << endl
+         << "               [--no-texcoords] [--no-normals] [--size S] [--seed S]" << endl
+         << "  scenegen scene <saida.txt> [--objects N] [--targets M] [--vehicles K] [--object-model arquivo]..." << endl
+         << "               [--target-model arquivo] [--vehicle-model arquivo] [--no-track] [--area A] [--seed S]" << endl
+         << "  scenegen suite <diretorio>   (série de escala: OBJs de 1e3 a 1e6 vertices e cenas de 10 a 10000 objetos)" << endl;
+}
+
+
+// Troca a extensão .obj por .mtl (MTL padrão ao lado do OBJ)
+static string mtlPadrao(const string& caminhoOBJ) {
+    return filesystem::path(caminhoOBJ).replace_extension(".mtl").generic_string();
+}
+
+
+static int gerarOBJ(int argc, char* argv[]) {
+    string caminhoOBJ = argv[2];
+    string caminhoMTL = mtlPadrao(caminhoOBJ);
+    SceneGenerator::OBJParams parametros;
+
+    for (int i = 3; i < argc; i++) {
+        string opcao = argv[i];
+        if      (opcao == "--no-texcoords") { parametros.texCoords = false; continue; }
+        else if (opcao == "--no-normals")   { parametros.normals = false; continue; }
+
+        if (i + 1 >= argc) { imprimirUso(); return EXIT_FAILURE; }
+        string valor = argv[++i];
+        if      (opcao == "--mtl")       { caminhoMTL = valor; }
+        else if (opcao == "--vertices")  { parametros.vertices = strtoull(valor.c_str(), nullptr, 10); }
+        else if (opcao == "--arity")     { parametros.arity = atoi(valor.c_str()); }
+        else if (opcao == "--groups")    { parametros.groups = atoi(valor.c_str()); }
+        else if (opcao == "--materials") { parametros.materials = atoi(valor.c_str()); }
+        else if (opcao == "--size")      { parametros.size = (float)atof(valor.c_str()); }
+        else if (opcao == "--seed")      { parametros.seed = (unsigned int)strtoul(valor.c_str(), nullptr, 10); }
+        else { imprimirUso(); return EXIT_FAILURE; }
+    }
+
+    if (!SceneGenerator::writeOBJ(caminhoOBJ, caminhoMTL, parametros)) return EXIT_FAILURE;
+    cout << "Modelo gravado: " << caminhoOBJ << " (" << caminhoMTL << ")" << endl;
+    return EXIT_SUCCESS;
+}
+
+
+static int gerarCena(int argc, char* argv[]) {
+    string caminho = argv[2];
+    SceneGenerator::SceneParams parametros;
+    bool modelosPadrao = true;     // o primeiro --object-model substitui a lista padrão
+
+    for (int i = 3; i < argc; i++) {
+        string opcao = argv[i];
+        if (opcao == "--no-track") { parametros.track = false; continue; }
+
+        if (i + 1 >= argc) { imprimirUso(); return EXIT_FAILURE; }
+        string valor = argv[++i];
+        if      (opcao == "--objects")  { parametros.objects = strtoull(valor.c_str(), nullptr, 10); }
+        else if (opcao == "--targets")  { parametros.targets = strtoull(valor.c_str(), nullptr, 10); }
+        else if (opcao == "--vehicles") { parametros.vehicles = strtoull(valor.c_str(), nullptr, 10); }
+        else if (opcao == "--object-model") {
+            if (modelosPadrao) { parametros.objectModels.clear(); modelosPadrao = false; }
+            parametros.objectModels.push_back(valor);
+        }
+        else if (opcao == "--target-model")  { parametros.targetModel = valor; }
+        else if (opcao == "--vehicle-model") { parametros.vehicleModel = valor; }
+        else if (opcao == "--area")          { parametros.area = (float)atof(valor.c_str()); }
+        else if (opcao == "--seed")          { parametros.seed = (unsigned int)strtoul(valor.c_str(), nullptr, 10); }
+        else { imprimirUso(); return EXIT_FAILURE; }
+    }
+
+    if (!SceneGenerator::writeScene(caminho, parametros)) return EXIT_FAILURE;
+    cout << "Cena gravada: " << caminho << " (" << parametros.objects << " obstaculos, " << parametros.targets
+         << " alvos, " << parametros.vehicles << " veiculos)" << endl;
+    return EXIT_SUCCESS;
+}
+
+
+// Série de escala: cada eixo cresce em potências de 10 com os demais fixos
+static int gerarSerie(const string& diretorio) {
+    filesystem::create_directories(diretorio);
+    string base = filesystem::path(diretorio).generic_string() + "/";
+
+    // Modelos: tamanho (quadriláteros, triângulos) e formato (polígonos de 6 lados, sem vt/vn, muitos grupos)
+    for (size_t vertices : { (size_t)1000, (size_t)10000, (size_t)100000, (size_t)1000000 }) {
+        SceneGenerator::OBJParams parametros;
+        parametros.vertices = vertices;
+        parametros.size = 20.0f;
+
+        string nome = base + "grade_" + to_string(vertices);
+        if (!SceneGenerator::writeOBJ(nome + ".obj", nome + ".mtl", parametros)) return EXIT_FAILURE;
+
+        parametros.arity = 3;
+        nome = base + "triangulos_" + to_string(vertices);
+        if (!SceneGenerator::writeOBJ(nome + ".obj", nome + ".mtl", parametros)) return EXIT_FAILURE;
+    }
+    {
+        SceneGenerator::OBJParams parametros;
+        parametros.vertices = 100000;
+        parametros.arity = 6;
+        parametros.size = 20.0f;
+        if (!SceneGenerator::writeOBJ(base + "hexagonos_100000.obj", base + "hexagonos_100000.mtl", parametros)) return EXIT_FAILURE;
+
+        parametros.arity = 4;
+        parametros.texCoords = false;
+        parametros.normals = false;
+        if (!SceneGenerator::writeOBJ(base + "somente_v_100000.obj", base + "somente_v_100000.mtl", parametros)) return EXIT_FAILURE;
+
+        parametros.texCoords = true;
+        parametros.normals = true;
+        parametros.groups = 256;
+        parametros.materials = 64;
+        if (!SceneGenerator::writeOBJ(base + "grupos256_100000.obj", base + "grupos256_100000.mtl", parametros)) return EXIT_FAILURE;
+    }
+
+    // Cenas: objetos (10% alvos) e veículos
+    for (size_t objetos : { (size_t)10, (size_t)100, (size_t)1000, (size_t)10000 }) {
+        SceneGenerator::SceneParams parametros;
+        parametros.objects = objetos - objetos / 10;
+        parametros.targets = objetos / 10;
+        parametros.area = objetos >= 1000 ? 200.0f : 40.0f;
+        if (!SceneGenerator::writeScene(base + "cena_objetos_" + to_string(objetos) + ".txt", parametros)) return EXIT_FAILURE;
+    }
+    for (size_t veiculos : { (size_t)1, (size_t)10, (size_t)100 }) {
+        SceneGenerator::SceneParams parametros;
+        parametros.vehicles = veiculos;
+        if (!SceneGenerator::writeScene(base + "cena_veiculos_" + to_string(veiculos) + ".txt", parametros)) return EXIT_FAILURE;
+    }
+
+    cout << "Serie de escala gravada em " << diretorio << endl;
+    return EXIT_SUCCESS;
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) { imprimirUso(); return EXIT_FAILURE; }
+
+    string comando = argv[1];
+    if (comando == "obj")   return gerarOBJ(argc, argv);
+    if (comando == "scene") return gerarCena(argc, argv);
+    if (comando == "suite" && argc == 3) return gerarSerie(argv[2]);
+
+    imprimirUso();
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,149 @@
+#ifndef AABBTREE_H
+#define AABBTREE_H
+
+#include <vector>
+#include <utility>
+#include <glm/glm.hpp>
+#include "Mesh.h"   // BoundingBox
+#include "CollisionKernels.h"
+
+using namespace std;
+using namespace glm;
+
+// Árvore dinâmica de AABBs (broad phase das colisões projétil x cena)
+// Cada folha guarda a bounding box de um objeto em coordenadas de mundo, "engordada" por uma margem:
+// enquanto o objeto animado se move dentro da caixa engordada a árvore não é alterada (move() retorna false),
+// e quando sai dela só a sua folha é removida e reinserida - a árvore nunca é reconstruída inteira.
+// Os nós internos envolvem os dois filhos e a árvore é mantida balanceada por rotações (como em uma AVL),
+// de forma que a consulta de um segmento visita apenas os ramos cujas caixas ele atravessa
+class AABBTree {
+public:
+    static const int NULL_NODE = -1;
+    static const int STACK_SIZE = 64;   // pilha das consultas: a árvore balanceada nunca chega perto desta altura
+
+    AABBTree();
+
+    // Insere a caixa de um objeto e retorna o identificador (proxy) da sua folha
+    int insert(const BoundingBox& box, void* userData);
+
+    // Remove a folha do objeto
+    void remove(int proxy);
+
+    // Atualiza a caixa de um objeto que se moveu; retorna true se a folha precisou ser reinserida
+    bool move(int proxy, const BoundingBox& box);
+
+    void* userData(int proxy) const { return nodes[proxy].userData; }
+    const BoundingBox& fatBox(int proxy) const { return nodes[proxy].box; }
+
+    size_t proxyCount() const { return leaves; }
+    int height() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+
+    // Remove todas as folhas
+    void clear();
+
+    // Visita as folhas cujas caixas são atravessadas pelo segmento p0 -> p1
+    // visitor(void* userData) retorna false para encerrar a consulta
+    // As consultas só leem a árvore (pilhas locais): várias threads podem consultar ao mesmo tempo
+    template <typename Visitor>
+    void querySegment(const vec3& p0, const vec3& p1, Visitor&& visitor) const;
+
+    // Visita as folhas atravessadas por algum raio do pacote; cada caixa é testada contra todos os raios
+    // de uma vez (CollisionKernels::raysVsBox). visitor(void* userData, unsigned int mask) recebe os bits
+    // dos raios que atravessam a folha
+    template <typename Visitor>
+    void queryPacket(const RayPacket& rays, Visitor&& visitor) const;
+
+private:
+    struct Node {
+        BoundingBox box;    // caixa engordada (folhas) ou união dos filhos (nós internos)
+        void* userData;     // objeto da folha (nullptr nos nós internos)
+        int parent;         // pai, ou próximo nó livre quando o nó está na lista de livres
+        int left, right;    // filhos (NULL_NODE nas folhas)
+        int height;         // 0 nas folhas, -1 nos nós livres
+
+        bool isLeaf() const { return left == NULL_NODE; }
+    };
+
+    vector<Node> nodes;     // nós em um vetor contínuo (índices em vez de ponteiros)
+    int root;
+    int freeList;           // primeiro nó livre
+    size_t leaves;
+
+    int  allocateNode();
+    void freeNode(int node);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int  balance(int node);
+    void refit(int node);   // recalcula caixas e alturas do nó até a raiz, rebalanceando
+
+    static BoundingBox merge(const BoundingBox& a, const BoundingBox& b);
+    static float area(const BoundingBox& box);
+    static bool contains(const BoundingBox& outer, const BoundingBox& inner);
+    static bool segmentOverlaps(const BoundingBox& box, const vec3& origin, const vec3& invDelta);
+};
+
+
+template <typename Visitor>
+void AABBTree::querySegment(const vec3& p0, const vec3& p1, Visitor&& visitor) const {
+    if (root == NULL_NODE) return;
+
+    vec3 invDelta = 1.0f / (p1 - p0);   // componentes nulas viram +-inf e o teste de slabs continua valendo
+
+    int stack[STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = root;
+    while (stackSize > 0) {
+        int index = stack[--stackSize];
+
+        const Node& node = nodes[index];
+        if (!segmentOverlaps(node.box, p0, invDelta)) continue;
+
+        if (node.isLeaf()) {
+            if (!visitor(node.userData)) return;
+        } else {
+            stack[stackSize++] = node.left;
+            stack[stackSize++] = node.right;
+        }
+    }
+}
+
+
+template <typename Visitor>
+void AABBTree::queryPacket(const RayPacket& rays, Visitor&& visitor) const {
+    if (root == NULL_NODE || rays.count == 0) return;
+
+    pair<int, unsigned int> stack[STACK_SIZE];  // nó e raios do pacote ainda ativos nele
+    int stackSize = 0;
+    stack[stackSize++] = make_pair(root, (1u << rays.count) - 1);
+    while (stackSize > 0) {
+        int index = stack[stackSize - 1].first;
+        unsigned int active = stack[stackSize - 1].second;
+        stackSize--;
+
+        const Node& node = nodes[index];
+        unsigned int mask = CollisionKernels::raysVsBox(rays, active, node.box.pontoMinimo, node.box.pontoMaximo);
+        if (mask == 0) continue;
+
+        if (node.isLeaf()) {
+            visitor(node.userData, mask);
+        } else {
+            stack[stackSize++] = make_pair(node.left, mask);
+            stack[stackSize++] = make_pair(node.right, mask);
+        }
+    }
+}
+
+
+// Teste de slabs do segmento p0 + t * delta, t em [0, 1], contra a caixa
+inline bool AABBTree::segmentOverlaps(const BoundingBox& box, const vec3& origin, const vec3& invDelta) {
+    vec3 t1 = (box.pontoMinimo - origin) * invDelta;
+    vec3 t2 = (box.pontoMaximo - origin) * invDelta;
+    vec3 tMin = min(t1, t2);
+    vec3 tMax = max(t1, t2);
+
+    float tNear = std::max(std::max(tMin.x, tMin.y), std::max(tMin.z, 0.0f));
+    float tFar  = std::min(std::min(tMax.x, tMax.y), std::min(tMax.z, 1.0f));
+    return tNear <= tFar;
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Mesh.h"
+
+using namespace std;
+
+// Carregamento dos modelos em segundo plano
+// Threads próprias executam a etapa sem OpenGL de cada modelo pedido (Mesh::loadData: MeshCache ou OBJ/MTL,
+// BVH e decodificação das texturas) e colocam a malha pronta em uma fila de concluídos. A thread do contexto
+// OpenGL retira as malhas dessa fila a cada quadro, dentro de um orçamento de envio (ver System::processLoadedAssets),
+// de forma que a primeira imagem não espera pela cena inteira e os objetos aparecem à medida que ficam prontos.
+// As threads são separadas do JobSystem porque cada carregamento leva de milissegundos a segundos: em uma fila
+// de jobs ele seria executado por quem estivesse esperando um parallelFor da simulação ou da renderização
+class AssetLoader {
+public:
+    // Modelo concluído: mesh = nullptr se o carregamento falhou
+    struct Result {
+        string path;
+        shared_ptr<Mesh> mesh;
+        double loadMs;      // duração da etapa de carregamento (na thread de carregamento)
+    };
+
+    AssetLoader();
+    ~AssetLoader();
+
+    // Inicia "threads" threads de carregamento (pelo menos uma)
+    void start(int threads);
+
+    // Encerra as threads depois do modelo que cada uma estiver carregando; os pedidos restantes são descartados
+    void stop();
+
+    // Pede o carregamento de um modelo (cada caminho deve ser pedido uma única vez)
+    void request(const string& modelPath);
+
+    // Retira um modelo concluído da fila; false se nenhum estiver pronto
+    bool takeCompleted(Result& result);
+
+    // Pedidos ainda não retirados por takeCompleted (na fila, em carregamento ou concluídos)
+    size_t pendingCount();
+
+    unsigned int threadCount() const { return (unsigned int)threads.size(); }
+
+private:
+    vector<thread> threads;
+    mutex lock;                     // protege as filas e os contadores abaixo
+    condition_variable wake;        // threads sem pedidos dormem aqui
+    deque<string> requests;
+    deque<Result> completed;
+    size_t pending;
+    bool stopping;
+
+    void workerLoop();
+};
+
+#endif
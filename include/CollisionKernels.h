@@ -0,0 +1,80 @@
+#ifndef COLLISIONKERNELS_H
+#define COLLISIONKERNELS_H
+
+#include <vector>
+#include <cstddef>
+#include <atomic>
+#include <glm/glm.hpp>
+
+using namespace std;
+using namespace glm;
+
+// Pacote de até PACKET_SIZE raios (segmentos de projéteis) em SoA, alinhado para cargas AVX
+struct RayPacket {
+    static const int PACKET_SIZE = 8;
+
+    alignas(32) float originX[PACKET_SIZE], originY[PACKET_SIZE], originZ[PACKET_SIZE];
+    alignas(32) float invDirX[PACKET_SIZE], invDirY[PACKET_SIZE], invDirZ[PACKET_SIZE]; // 1 / direção
+    alignas(32) float tMax[PACKET_SIZE];     // alcance de cada raio (t em [0, tMax])
+    int count;                               // raios válidos no pacote
+
+    RayPacket() : count(0) {}
+
+    // Acrescenta um raio; componentes nulas da direção viram um valor mínimo para não gerar 0 * inf = NaN
+    void add(const vec3& origin, const vec3& direction, float maxDistance);
+};
+
+// Triângulos em SoA (vértice v0 e arestas e1 = v1 - v0, e2 = v2 - v0), com folga no final
+// para que as cargas de 4 ou 8 triângulos nunca leiam fora dos vetores
+struct TriangleSoA {
+    vector<float> v0x, v0y, v0z;
+    vector<float> e1x, e1y, e1z;
+    vector<float> e2x, e2y, e2z;
+
+    void resize(size_t count);      // count triângulos + folga (triângulos nulos)
+    void set(size_t index, const vec3& v0, const vec3& v1, const vec3& v2);
+    void clear();
+};
+
+// Núcleos SIMD dos testes de colisão, com a implementação escolhida em tempo de execução:
+// AVX (8 faixas) ou SSE (4 faixas) quando a CPU suporta, senão a versão escalar
+class CollisionKernels {
+public:
+    enum Level { SCALAR, SSE, AVX };
+
+    // Nível em uso (o melhor suportado, escolhido na inicialização do programa) e troca manual (limitada ao
+    // suportado pela CPU). A troca pode ser feita com as colisões em andamento em outras threads: cada chamada
+    // usa por inteiro o conjunto de núcleos anterior ou o novo
+    static Level level();
+    static Level supportedLevel();
+    static void setLevel(Level requested);
+    static const char* levelName(Level value);
+
+    // Testa os raios ativos do pacote (bits de "active") contra a caixa; bit i do retorno = raio i atravessa a caixa
+    // As versões SIMD testam o pacote inteiro de uma vez; a escalar percorre só os bits ativos
+    static unsigned int raysVsBox(const RayPacket& rays, unsigned int active, const vec3& boxMin, const vec3& boxMax);
+
+    // Testa um raio contra os triângulos [first, first + count); retorna o índice do mais próximo
+    // com t em (0, tClosest] (atualizando tClosest, u e v) ou -1 se nenhum for atingido
+    static long rayVsTriangles(const TriangleSoA& tris, size_t first, size_t count,
+                               const vec3& origin, const vec3& direction,
+                               float& tClosest, float& u, float& v);
+
+private:
+    typedef unsigned int (*RaysVsBoxFn)(const RayPacket&, unsigned int, const vec3&, const vec3&);
+    typedef long (*RayVsTrianglesFn)(const TriangleSoA&, size_t, size_t, const vec3&, const vec3&,
+                                     float&, float&, float&);
+
+    // Conjunto de núcleos de um nível; "current" aponta para um dos conjuntos constantes (troca atômica)
+    struct Kernels {
+        Level level;
+        RaysVsBoxFn raysVsBox;
+        RayVsTrianglesFn rayVsTriangles;
+    };
+
+    static atomic<const Kernels*> current;
+
+    static const Kernels* kernelsFor(Level value);
+};
+
+#endif
@@ -22,6 +22,10 @@ public:
 
     // Converte face com 4 ou mais vértices em triângulos usando "fan triangulation"
     vector<Face> triangulate() const;
+
+    // Mesma triangulação, mas acrescenta os triângulos diretamente ao vetor "triangles"
+    // (evita o vetor temporário - usado por Group::addFace durante a leitura do OBJ)
+    void triangulate(vector<Face>& triangles) const;
 };
 
 #endif
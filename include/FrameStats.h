@@ -0,0 +1,42 @@
+#ifndef FRAMESTATS_H
+#define FRAMESTATS_H
+
+#include <vector>
+#include <string>
+
+using namespace std;
+
+// Amostras de duração de quadro (ms) de uma execução e o resumo delas (mínimo, média, percentis, máximo)
+// Usado pelas execuções roteirizadas (System::runScripted), em que cada quadro e cada etapa do quadro são medidos
+// separadamente, para comparar versões do caminho de renderização sempre com a mesma cena
+class FrameStats {
+public:
+    struct Summary {
+        size_t frames;
+        double minMs, avgMs, p50Ms, p95Ms, p99Ms, maxMs;
+    };
+
+    void reserve(size_t frames) { samples.reserve(frames); }
+    void add(double ms) { samples.push_back(ms); }
+    void clear() { samples.clear(); }
+    size_t size() const { return samples.size(); }
+
+    Summary summary() const;
+
+    // Percentil (0 a 100) pelo método do posto mais próximo
+    double percentile(double p) const;
+
+    // Imprime o resumo em uma linha
+    void print(const string& label) const;
+
+    // Resumo como objeto JSON: {"min": ..., "avg": ..., "p50": ..., "p95": ..., "p99": ..., "max": ...} (ms)
+    string toJSON() const;
+
+    // Grava uma linha "quadro,ms" por amostra (CSV com cabeçalho); false se o arquivo não puder ser criado
+    bool writeCSV(const string& path) const;
+
+private:
+    vector<double> samples;     // na ordem dos quadros
+};
+
+#endif
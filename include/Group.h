@@ -5,6 +5,7 @@
 #include <string>
 #include "Face.h"
 #include "Material.h"
+#include "UniformBuffer.h"
 
 using namespace std;
 using namespace glm;
@@ -15,20 +16,24 @@ public:
     vector<Face> faces;
     Material material;  // Material associado ao grupo
     
-    // OpenGL objects
-    unsigned int VAO;
-    unsigned int VBO;
     unsigned int textureID;  // ID da textura carregada do material MTL
 
-    // Vetor de dados (floats) dos vértices (posições, normais, coordenadas de textura)
-    // para envio à OpenGL. Armazena sequencialmente os atributos de cada vértice.
-    // Exemplo: v1.x, v1.y, v1.z, v1.nx, v1.ny, v1.nz, v1.u, v1.v, v2.x, v2.y, ...
+    // Vetor de dados (floats) dos vértices ÚNICOS do grupo (posições, normais, coordenadas de textura)
+    // montado por buildVertexData. Armazena sequencialmente os atributos de cada vértice.
+    // Exemplo: v1.x, v1.y, v1.z, v1.u, v1.v, v1.nx, v1.ny, v1.nz, v2.x, v2.y, ...
     // Cada grupo de 8 floats representa um vértice (posição<3> + texCoord<2> + normal<3>)
+    // Cantos de triângulos com a mesma combinação de índices (v, vt, vn) compartilham o mesmo vértice
     vector<float> vertices;
 
-    int vertexCount; // Número de vértices do grupo para envio à glDrawArrays
-                     // cada vértice tem 8 floats (posição<3> + texCoord<2> + normal<3>)
-                     // logo, vertexCount = vertices.size() / 8
+    // Índices dos vértices (em "vertices") de cada canto dos triângulos, 3 por triângulo
+    vector<unsigned int> indices;
+    // "vertices" e "indices" são copiados para o buffer único da malha (Mesh::setupBuffers) e então liberados
+
+    // Faixa do grupo dentro dos buffers compartilhados da malha (um único VBO/EBO/VAO por Mesh)
+    int vertexCount;          // Número de vértices únicos do grupo (8 floats cada)
+    int indexCount;           // Número de índices do grupo para envio à glDrawElements (3 por triângulo)
+    unsigned int baseVertex;  // Posição do primeiro vértice do grupo no VBO da malha
+    unsigned int firstIndex;  // Posição do primeiro índice do grupo no EBO da malha
     
     Group();
 
@@ -38,20 +43,22 @@ public:
 
     void addFace(const Face& face);
 
-    // Configura os buffers de OpenGL (VBO e VAO) para o grupo em processamento
+    // Monta os vértices únicos e os índices do grupo ("vertices" e "indices") para envio à OpenGL
     // recebe referência dos vetores que guardam a posição, textura e normais do
     // objeto/Grupo em processamento,acessados através dos índices das faces do grupo
-    void setupBuffers(const vector<vec3>& objVertices,
-                      const vector<vec2>& objTexCoords,
-                      const vector<vec3>& objNormals);
-
+    // Os cantos repetidos são eliminados (deduplicação) e os triângulos passam a ser indexados
+    // Os buffers OpenGL são criados depois, para todos os grupos juntos, em Mesh::setupBuffers
+    void buildVertexData(const vector<vec3>& objVertices,
+                         const vector<vec2>& objTexCoords,
+                         const vector<vec3>& objNormals);
 
     // Alteramos para o Grau B
-    // Renderiza o grupo de faces, enviando propriedades do material do grupo para os shaders                  
-    void render(const class Shader& shader) const; // No Grau A era void Group::render() const;  // Alterado para receber referência do shader
+    // Propriedades do material (Ka, Kd, Ks, Ns) no layout std140 do bloco "MaterialData"
+    // O desenho da faixa do grupo (com a sua textura) é feito pela fila de renderização (ver Mesh::submit)
+    MaterialUniforms materialUniforms() const;
 
-    // Carrega a textura do material MTL
-    void loadMaterialTexture(const string& modelDirectory);
+    // Verifica se o grupo usa o mesmo material/textura que outro (podem ser desenhados juntos)
+    bool sameMaterial(const Group& other) const;
 
     void cleanup();
 };
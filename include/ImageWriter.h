@@ -0,0 +1,19 @@
+#ifndef IMAGEWRITER_H
+#define IMAGEWRITER_H
+
+#include <string>
+
+using namespace std;
+
+// Gravação de imagens PNG (quadros das execuções roteirizadas, ver System::runScripted)
+// O stb_image do projeto só lê imagens; este gravador gera o PNG sem compressão (blocos "stored" do deflate),
+// o que basta para comparar quadros e é lido por qualquer visualizador
+class ImageWriter {
+public:
+    // pixels: height linhas de width * channels bytes (channels 3 = RGB, 4 = RGBA)
+    // flipVertical = true para imagens lidas com glReadPixels (primeira linha = base da imagem)
+    static bool writePNG(const string& path, int width, int height, int channels,
+                         const unsigned char* pixels, bool flipVertical);
+};
+
+#endif
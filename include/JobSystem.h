@@ -0,0 +1,137 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <initializer_list>
+
+using namespace std;
+
+// Conjunto fixo de threads que executam jobs (funções curtas) com roubo de trabalho
+// Cada thread tem a sua fila: empilha e retira os próprios jobs pelo fim (os mais recentes, ainda no cache)
+// e, quando fica sem trabalho, rouba o job mais antigo do início da fila de outra thread. Threads de fora
+// do conjunto (renderização, simulação) enfileiram cada uma em uma fila de entrada própria, também roubada
+// pelas threads do conjunto. Quem espera por um lote (wait) executa jobs enquanto espera, em vez de bloquear;
+// uma thread de fora só executa os jobs da sua fila de entrada, para que a renderização não pegue uma fase
+// inteira da simulação (ou o contrário) enquanto espera o seu parallelFor
+class JobSystem {
+public:
+    typedef function<void()> Job;
+
+    // Jobs ainda não concluídos de um lote; wait() retorna quando chega a zero
+    struct Counter {
+        atomic<int> pending;
+        Counter() : pending(0) {}
+    };
+
+    // workers = threads do conjunto além de quem chama wait (-1 = núcleos da CPU - 1)
+    explicit JobSystem(int workers = -1);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Recria o conjunto com outro número de threads (não pode haver jobs em andamento)
+    void resize(int workers);
+
+    unsigned int workerCount() const { return (unsigned int)threads.size(); }
+
+    // Enfileira um job do lote "counter"
+    void run(Counter& counter, Job job);
+
+    // Executa jobs até que todos os do lote terminem
+    void wait(Counter& counter);
+
+    // Divide [begin, end) em blocos de até "grain" índices e chama body(inicio, fim) para cada bloco,
+    // retornando quando todos terminarem. Um único bloco é executado direto, sem passar pelas filas
+    template <typename Body>
+    void parallelFor(size_t begin, size_t end, size_t grain, Body&& body);
+
+private:
+    struct Task {
+        Job job;
+        Counter* counter;
+    };
+
+    struct Queue {
+        mutex lock;
+        deque<Task> tasks;
+    };
+
+    vector<thread> threads;
+    static constexpr unsigned int ENTRY_QUEUES = 8;    // filas de entrada (threads de fora além disso compartilham)
+
+    vector<unique_ptr<Queue>> queues;   // uma por thread do conjunto + ENTRY_QUEUES filas de entrada (no fim)
+    atomic<int> queued;                 // jobs em todas as filas
+    atomic<bool> stopping;
+    mutex sleepLock;
+    condition_variable wake;            // threads sem trabalho dormem aqui até haver jobs
+
+    void start(int workers);
+    void stop();
+    void workerLoop(unsigned int index);
+    bool tryExecute(unsigned int home, bool stealOthers); // executa um job (da própria fila ou roubado); false se não há jobs
+    bool pop(unsigned int queue, Task& task);
+    bool steal(unsigned int queue, Task& task);
+    void execute(Task& task);
+    unsigned int homeQueue() const;     // fila da thread atual (a sua fila de entrada para threads de fora)
+};
+
+
+// Grafo de tarefas com dependências, executado sobre o JobSystem
+// Cada tarefa é enfileirada quando todas as suas dependências terminam; tarefas independentes rodam em paralelo.
+// O grafo é montado uma vez e pode ser executado a cada passo; a duração de cada tarefa fica em micros()
+class TaskGraph {
+public:
+    // Acrescenta uma tarefa e retorna o seu índice (usado como dependência de tarefas acrescentadas depois)
+    int add(const char* name, JobSystem::Job job, initializer_list<int> dependencies = {});
+
+    // Executa todas as tarefas respeitando as dependências e retorna quando a última terminar
+    void execute(JobSystem& jobs);
+
+    void clear() { nodes.clear(); }
+    size_t size() const { return nodes.size(); }
+    const char* name(int task) const { return nodes[task]->name; }
+    double micros(int task) const { return nodes[task]->micros; }   // duração na última execução
+
+private:
+    struct Node {
+        const char* name;
+        JobSystem::Job job;
+        vector<int> dependents;     // tarefas que esperam por esta
+        int dependencyCount;
+        atomic<int> remaining;      // dependências ainda não concluídas na execução atual
+        double micros;
+    };
+
+    vector<unique_ptr<Node>> nodes;
+
+    void launch(JobSystem& jobs, JobSystem::Counter& counter, int task);
+};
+
+
+template <typename Body>
+void JobSystem::parallelFor(size_t begin, size_t end, size_t grain, Body&& body) {
+    if (begin >= end) return;
+    if (grain == 0) { grain = 1; }
+
+    if (threads.empty() || end - begin <= grain) {
+        body(begin, end);
+        return;
+    }
+
+    Counter counter;
+    for (size_t inicio = begin; inicio < end; inicio += grain) {
+        size_t fim = end - inicio > grain ? inicio + grain : end;
+        run(counter, [&body, inicio, fim]() { body(inicio, fim); });
+    }
+    wait(counter);
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+
+using namespace std;
+
+// Arquivo mapeado em memória (somente leitura)
+// Usado pelo OBJReader para percorrer o conteúdo do arquivo diretamente, sem copiar
+// linhas para strings intermediárias (getline + istringstream)
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // Não copiável: o mapeamento pertence a uma única instância
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Mapeia o arquivo inteiro em memória. Retorna false se não conseguir abrir/mapear
+    bool open(const string& path);
+
+    // Desfaz o mapeamento e fecha o arquivo
+    void close();
+
+    const char* data() const { return fileData; }   // início do conteúdo do arquivo
+    size_t size() const { return fileSize; }        // tamanho do arquivo em bytes
+    bool isOpen() const { return opened; }
+
+private:
+    const char* fileData;
+    size_t fileSize;
+    bool opened;
+
+#ifdef _WIN32
+    void* fileHandle;       // HANDLE do arquivo
+    void* mappingHandle;    // HANDLE do mapeamento
+#else
+    int fileDescriptor;
+#endif
+};
+
+#endif
@@ -7,6 +7,9 @@
 #include <glm/glm.hpp>
 #include "Group.h"
 #include "Material.h"
+#include "UniformBuffer.h"
+#include "MeshBVH.h"
+#include "Texture.h"
 
 using namespace std;
 using namespace glm;
@@ -47,20 +50,82 @@ public:
     vector<vec3> vertices;  // Vetor que armazena os vértices da malha (objeto 3D)
     vector<vec2> texCoords; // Vetor que armazena as coordenadas de textura da malha (objeto 3D)
     vector<vec3> normals;   // Vetor que armazena as normais da malha (objeto 3D)
+                            // (vertices, texCoords e normals ficam vazios quando a malha vem do MeshCache)
     vector<Group> groups;   // Vetor que armazena os grupos que compõem a malha (objeto 3D)
     map<string, Material> materials;  // Mapa de materiais que podem ser usados em cada grupo da malha (objeto 3D)
+    vector<string> materialFiles;     // Arquivos MTL citados pelo OBJ (mtllib): parte da chave do MeshCache
     
     BoundingBox boundingBox;    // estrutura da bounding box do objeto 3D
+    MeshBVH bvh;                // hierarquia dos triângulos da malha (colisões exatas, em espaço do modelo)
+
+    // Buffers OpenGL únicos da malha: os vértices e índices de todos os grupos ficam lado a lado
+    // e cada grupo guarda apenas a sua faixa (Group::baseVertex/firstIndex/vertexCount/indexCount)
+    unsigned int VAO, VBO, EBO;
+    unsigned int indexType;     // GL_UNSIGNED_SHORT (até 65535 vértices na malha) ou GL_UNSIGNED_INT
+
+    // Instanciamento: matrizes de modelo de todos os objetos da cena que usam esta malha
+    // (atributos 3 a 6 do VAO, avançando uma vez por instância), regravadas a cada quadro
+    unsigned int instanceVBO;
+    size_t instanceCapacity;    // número de matrizes que cabem no instanceVBO
+    vector<mat4> instances;     // transformações acumuladas no quadro atual (ver addInstance)
+
+    // Cópia em memória dos dados enviados aos buffers (8 floats por vértice e índices já deslocados
+    // para a posição de cada grupo no VBO) - usada para gravar o MeshCache
+    vector<float> vertexData;
+    vector<unsigned int> indexData;
+
+    // Lote de desenho: grupos consecutivos com o mesmo material, desenhados em uma única chamada
+    struct DrawBatch {
+        size_t group;               // grupo cujo material é aplicado ao lote
+        unsigned int firstIndex;    // primeiro índice do lote no EBO
+        unsigned int indexCount;    // número de índices do lote
+        size_t materialOffset;      // posição do material do lote em materialBuffer
+    };
+    vector<DrawBatch> drawBatches;
+
+    // Propriedades dos materiais dos lotes (bloco "MaterialData"), uma entrada alinhada por lote
+    UniformBuffer materialBuffer;
+
+    // Diretório do modelo (base dos caminhos das texturas do MTL) e texturas decodificadas por loadData,
+    // aguardando o envio à OpenGL em upload (caminho completo -> imagem)
+    string modelDirectory;
+    map<string, TextureImage> stagedTextures;
     
     Mesh();  // Construtor padrão
     ~Mesh(); // Destrutor
 
     // Carrega dados do OBJ chamando OBJReader::readFileOBJ, método da classe OBJReader.
     // Este, por sua vez, preenche os vetores e mapas passados por referência.
+    // Equivale a loadData seguido de upload, na thread do contexto OpenGL
     bool readObjectModel(string& path);
 
-    // Renderiza a malha chamando render() de cada grupo
-    void render(const class Shader& shader) const;
+    // Etapa sem OpenGL do carregamento (pode rodar em uma thread de carregamento - ver AssetLoader):
+    // lê o MeshCache ou o OBJ/MTL, monta vertexData/indexData, bounding box e BVH e decodifica as texturas
+    bool loadData(const string& path);
+
+    // Etapa OpenGL: cria as texturas decodificadas, os buffers da malha e os lotes de desenho
+    void upload();
+
+    // Bytes que upload enviará à OpenGL (vértices, índices e texturas) - orçamento de envio por quadro
+    size_t uploadBytes() const;
+
+    // Junta os dados de todos os grupos (Group::buildVertexData) em vertexData/indexData, os dados dos
+    // buffers únicos da malha. Os grupos são ordenados por material para que os lotes de desenho fiquem contíguos
+    void setupBuffers();
+
+    // Cria VAO, VBO e EBO da malha a partir dos vértices (8 floats cada) e índices informados
+    void uploadBuffers(const float* vertexFloats, size_t floatCount,
+                       const unsigned int* indexValues, size_t indexCount);
+
+    // Monta os lotes de desenho a partir das faixas dos grupos e o buffer de materiais dos lotes
+    void buildDrawBatches();
+
+    // Acrescenta uma instância (matriz de modelo de um objeto) ao quadro atual
+    void addInstance(const mat4& transform) { instances.push_back(transform); }
+
+    // Envia as instâncias acumuladas para o instanceVBO e os lotes de desenho da malha para a fila
+    // de renderização (um item instanciado por lote de material); esvazia as instâncias do quadro
+    void submit(class RenderQueue& queue, const class Shader& shader, const vec3& objectColor);
 
     // Limpa os dados da malha e libera recursos OpenGL
     void cleanup();
@@ -68,9 +133,13 @@ public:
     // Calcula a bounding box do modelo/objeto
     void calculateBoundingBox();
 
-    // Testa interseção do segmento (ray) com a bounding box (retorna true se houver interseção)
+    // Monta a BVH dos triângulos a partir de vertexData/indexData
+    void buildBVH();
+
+    // Testa o raio contra os triângulos da malha (bounding box primeiro, depois a BVH)
+    // Retorna o triângulo mais próximo com t em (0, maxDistance], em espaço do modelo
     bool rayIntersect(const vec3& rayOrigin, const vec3& rayDirection,
-                     float& distance) const;
+                      float maxDistance, RayHit& hit) const;
 };
 
 #endif
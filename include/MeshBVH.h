@@ -0,0 +1,79 @@
+#ifndef MESHBVH_H
+#define MESHBVH_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "CollisionKernels.h"
+
+using namespace std;
+using namespace glm;
+
+// Resultado de um teste de raio contra os triângulos de uma malha
+struct RayHit {
+    float distance;         // parâmetro t do raio no ponto atingido (origem + direção * t)
+    unsigned int triangle;  // triângulo atingido (posição em Mesh::indexData / 3)
+    float u, v;             // coordenadas baricêntricas do ponto (peso de v1 e v2; v0 = 1 - u - v)
+    vec3 normal;            // normal geométrica do triângulo (normalizada, no espaço em que o teste foi feito)
+};
+
+// BVH (bounding volume hierarchy) dos triângulos de uma malha, em espaço do modelo
+// Construída uma vez por malha (Mesh::readObjectModel) a partir de vertexData/indexData, dividindo os
+// triângulos pela heurística de área de superfície (SAH) avaliada em bins ao longo de cada eixo.
+// Os nós ficam em um vetor contínuo de 32 bytes cada, com os dois filhos lado a lado, e os triângulos são
+// copiados em SoA na ordem das folhas - a travessia lê memória próxima e não segue ponteiros, e os
+// triângulos de cada folha são testados juntos pelos núcleos SIMD (CollisionKernels::rayVsTriangles)
+class MeshBVH {
+public:
+    MeshBVH();
+
+    // Constrói a hierarquia; vertexFloats tem 8 floats por vértice (posição nos 3 primeiros)
+    void build(const float* vertexFloats, size_t vertexCount,
+               const unsigned int* indices, size_t indexCount);
+
+    // Triângulo mais próximo atingido pelo raio com t em (0, maxDistance]
+    // A direção não precisa ser normalizada: distance é medida no parâmetro do próprio raio
+    bool intersect(const vec3& origin, const vec3& direction, float maxDistance, RayHit& hit) const;
+
+    bool empty() const { return nodes.empty(); }
+    size_t triangleCount() const { return triangleIds.size(); }
+    size_t nodeCount() const { return nodes.size(); }
+
+    void clear();
+
+private:
+    // Nó de 32 bytes: folha quando count > 0 (triângulos [leftFirst, leftFirst + count)),
+    // senão nó interno com filhos em leftFirst e leftFirst + 1
+    struct Node {
+        vec3 boundsMin;
+        unsigned int leftFirst;
+        vec3 boundsMax;
+        unsigned int count;
+    };
+    static_assert(sizeof(Node) == 32, "MeshBVH::Node deve ocupar 32 bytes");
+
+    struct Triangle {
+        vec3 v0, v1, v2;
+    };
+
+    static const int BIN_COUNT = 16;        // bins por eixo na avaliação da SAH
+    static const unsigned int LEAF_SIZE = 4;    // folhas com até 4 triângulos (uma carga SSE) não são divididas
+    static const int MAX_DEPTH = 64;        // limite da pilha de travessia
+
+    vector<Node> nodes;
+    TriangleSoA triangles;                  // na ordem das folhas
+    vector<unsigned int> triangleIds;       // triângulo original de cada posição de "triangles"
+
+    // Dados temporários da construção
+    vector<Triangle> buildTriangles;        // triângulos na ordem original
+    vector<vec3> centroids;
+    vector<unsigned int> order;
+
+    void updateBounds(Node& node) const;
+    void subdivide(unsigned int nodeIndex, int depth);
+    float findBestSplit(const Node& node, int& axis, float& splitPos) const;
+
+    static float area(const vec3& boundsMin, const vec3& boundsMax);
+    static float intersectBox(const Node& node, const vec3& origin, const vec3& invDir, float tMax);
+};
+
+#endif
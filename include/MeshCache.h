@@ -0,0 +1,58 @@
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include <string>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+class Mesh;
+
+// Cache binário da malha, gravado ao lado do arquivo OBJ ("modelo.obj" -> "modelo.obj.meshcache")
+// Guarda o resultado já processado da leitura: os vértices únicos intercalados da malha
+// (posição<3> + texCoord<2> + normal<3>), seus índices, a faixa de cada grupo dentro deles,
+// a tabela de materiais e a bounding box.
+// Na próxima execução Mesh::loadData mapeia o cache em memória e copia os vértices e os índices
+// prontos para envio à OpenGL, sem ler o OBJ/MTL em formato texto.
+// O cache é identificado pelo caminho, tamanho e data de modificação do arquivo OBJ e de cada arquivo
+// de que a malha depende (MTL citados pelo OBJ e texturas dos materiais): se algum deles mudar, o cache
+// é descartado e regravado a partir do OBJ.
+// Os grupos gravados já incluem a reordenação do MeshOptimizer, quando ligada.
+class MeshCache {
+public:
+    // Versão do formato do arquivo de cache - incrementar sempre que o formato mudar
+    static const uint32_t VERSION = 5;   // 2: grupos indexados (vértices únicos + índices)
+                                        // 3: flag de otimização (MeshOptimizer) no cabeçalho
+                                        // 4: buffers únicos da malha com a faixa de cada grupo
+                                        // 5: MTL e texturas (caminho, tamanho e data) na chave
+
+    // Liga/desliga o uso do cache (leitura e gravação)
+    static bool enabled;
+
+    // Caminho do arquivo de cache associado ao arquivo OBJ
+    static string cachePath(const string& objFilePath);
+
+    // Carrega a malha a partir do cache, se ele existir e estiver atualizado em relação ao OBJ
+    // Preenche grupos, materiais, bounding box e vertexData/indexData (sem OpenGL: pode rodar em qualquer thread)
+    // Retorna false se não houver cache válido (a malha deve então ser lida do OBJ)
+    static bool load(const string& objFilePath, Mesh& mesh);
+
+    // Grava o cache da malha já lida do OBJ (com os buffers da malha já montados)
+    static bool save(const string& objFilePath, const Mesh& mesh);
+
+private:
+    // Tamanho e data de modificação do arquivo OBJ (chave do cache)
+    static bool sourceInfo(const string& objFilePath, uint64_t& size, int64_t& mtime);
+
+    // Arquivos de que a malha lida do OBJ depende: os MTL (Mesh::materialFiles) e as texturas dos grupos,
+    // com os caminhos usados por Mesh::loadData
+    static vector<string> dependencies(const Mesh& mesh);
+
+    // Tamanho e data de um arquivo de dependência; um arquivo ausente também é registrado
+    // (tamanho MISSING_FILE), para que o cache seja descartado quando ele for criado
+    static void dependencyInfo(const string& path, uint64_t& size, int64_t& mtime);
+    static const uint64_t MISSING_FILE = ~(uint64_t)0;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+#include <vector>
+#include <string>
+
+using namespace std;
+
+// Otimização da ordem dos triângulos e vértices de um grupo já indexado (ver Group::buildVertexData)
+// 1. Reordena os triângulos para reaproveitar o cache de vértices transformados da GPU ("Tipsify")
+// 2. Ordena os clusters de triângulos de fora para dentro do modelo, reduzindo o overdraw
+// 3. Renumera os vértices na ordem em que são usados pelos índices (localidade na leitura do VBO)
+// O resultado fica em Group::vertices/indices e é gravado no cache da malha (MeshCache)
+class MeshOptimizer {
+public:
+    // Tamanho do cache de vértices considerado na otimização e nas estatísticas (FIFO)
+    static const unsigned int CACHE_SIZE = 16;
+
+    // Liga/desliga a otimização na leitura dos modelos
+    static bool enabled;
+
+    // Otimiza os triângulos ("indices", 3 por triângulo) e os vértices ("vertices", 8 floats por vértice,
+    // posição nos 3 primeiros) de um grupo, imprimindo ACMR/ATVR antes e depois
+    static void optimize(vector<float>& vertices, vector<unsigned int>& indices, const string& groupName);
+
+    // ACMR (Average Cache Miss Ratio): vértices transformados por triângulo, simulando um cache FIFO
+    // Ideal ~0.5 em malhas grandes; 3.0 = nenhum reaproveitamento
+    static float calculateACMR(const vector<unsigned int>& indices, unsigned int cacheSize = CACHE_SIZE);
+
+    // ATVR (Average Transformed Vertex Ratio): vértices transformados por vértice único (ideal = 1.0)
+    static float calculateATVR(const vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize = CACHE_SIZE);
+
+    // Reordena os triângulos com o algoritmo Tipsify (Sander, Nehab e Barczak, 2007)
+    // "clusters" recebe o índice do primeiro triângulo de cada trecho contínuo gerado pelo algoritmo
+    static void optimizeVertexCache(vector<unsigned int>& indices, size_t vertexCount,
+                                    vector<size_t>& clusters, unsigned int cacheSize = CACHE_SIZE);
+
+    // Ordena os clusters de triângulos dos mais externos (voltados para fora) para os mais internos
+    // Os triângulos dentro de cada cluster mantêm a ordem, preservando o uso do cache
+    static void optimizeOverdraw(vector<unsigned int>& indices, const vector<float>& vertices,
+                                 const vector<size_t>& clusters);
+
+    // Renumera os vértices na ordem do primeiro uso pelos índices
+    static void optimizeVertexFetch(vector<float>& vertices, vector<unsigned int>& indices);
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef MODELREGISTRY_H
+#define MODELREGISTRY_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include "Mesh.h"
+
+using namespace std;
+
+// Registro dos modelos (arquivos OBJ) já carregados
+// Objetos da cena com o mesmo caminho de modelo compartilham a mesma malha: o OBJ é lido uma única vez
+// e todas as cópias são desenhadas juntas, por instanciamento (ver Mesh::addInstance e Mesh::submit)
+class ModelRegistry {
+public:
+    // Retorna a malha do modelo, lendo o arquivo (ou o MeshCache) apenas no primeiro pedido
+    // Retorna nullptr se o modelo não pôde ser carregado
+    static shared_ptr<Mesh> load(string& modelPath);
+
+    // Registra uma malha já carregada e enviada à OpenGL (carregamento em segundo plano - ver AssetLoader)
+    static void add(const string& modelPath, const shared_ptr<Mesh>& mesh) { registry[modelPath] = mesh; }
+
+    // Modelos carregados (caminho -> malha)
+    static const map<string, shared_ptr<Mesh>>& models() { return registry; }
+
+    // Libera as malhas do registro (chamar antes de destruir o contexto OpenGL)
+    static void clear();
+
+private:
+    static map<string, shared_ptr<Mesh>> registry;
+};
+
+#endif
@@ -14,41 +14,54 @@ using namespace glm;
 class OBJReader {
 public:
 
+    // Tamanho mínimo (em bytes) de cada bloco na leitura paralela automática do OBJ
+    static const size_t PARALLEL_MIN_CHUNK = 1 << 20;   // 1 MB
+
     // Lê um arquivo OBJ e preenche os vetores e grupos fornecidos por referência
+    // numThreads: 0 = automático (um bloco por núcleo, serial para arquivos pequenos),
+    //             1 = leitura serial, N = divide o arquivo em N blocos lidos em paralelo
+    // materialFiles: se informado, recebe os caminhos dos arquivos MTL citados pelo OBJ (mtllib), na ordem do arquivo
     static bool readFileOBJ(const string& path,
                         vector<vec3>& vertices,
                         vector<vec2>& texCoords,
                         vector<vec3>& normals,
                         vector<Group>& groups,
-                        map<string, Material>& materials);
+                        map<string, Material>& materials,
+                        unsigned int numThreads = 0,
+                        vector<string>* materialFiles = nullptr);
     
     // Lê um arquivo MTL e preenche o mapa de materiais fornecido por referência
     static bool readFileMTL(const string& path, map<string, Material>& materials);
     
-    // Divide uma string em substrings com base em um delimitador
-    static vector<string> split(const string& str, char delimiter);
-
     // Remove espaços em branco do início e fim de uma string
     static string trim(const string& str);
 
     // Extrai o diretório de um caminho de arquivo
     static string getDirectory(const string& filepath);
 
-    // Analisa uma linha do arquivo OBJ e preenche os indices da face
+    // Os métodos abaixo trabalham diretamente sobre o conteúdo do arquivo mapeado em memória:
+    // recebem o intervalo [line, end) da linha, já sem o prefixo ("f", "v", "vt", "vn"),
+    // e não criam strings nem streams intermediários
+
+    // Analisa uma linha do arquivo OBJ ("f") e preenche os indices da face
     // nos vetores de índices da face (vertexIndices, textureIndices, normalIndices)
-    static void parseFace(const string& faceStr, Face& face);
+    static void parseFace(const char* line, const char* end, Face& face);
 
     // Analisa uma linha do arquivo OBJ ("v") e preenche os dados de posição do vértice
     // no vetor de vértices (vec3)
-    static void parseVertice(const string& line, vector<vec3>& vertices);
+    static void parseVertice(const char* line, const char* end, vector<vec3>& vertices);
 
     // Analisa uma linha do arquivo OBJ ("vt") e preenche os dados de coordenadas de textura
     // no vetor de coordenadas de textura (vec2)
-    static void parseTexCoord(const string& line, vector<vec2>& texCoords);
+    static void parseTexCoord(const char* line, const char* end, vector<vec2>& texCoords);
 
     // Analisa uma linha do arquivo OBJ ("vn") e preenche os dados de normais
     // no vetor de normais (vec3)
-    static void parseNormal(const string& line, vector<vec3>& normals);
+    static void parseNormal(const char* line, const char* end, vector<vec3>& normals);
+
+    // Lê o próximo número real do intervalo [p, end), ignorando espaços antes dele
+    // Retorna o ponteiro para o caractere seguinte ao número (value = 0 se não houver número)
+    static const char* parseFloat(const char* p, const char* end, float& value);
 };
 
 #endif
@@ -2,6 +2,7 @@
 #define OBJECT3D_H
 
 #include <string>
+#include <memory>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "Mesh.h"
@@ -13,13 +14,20 @@ using namespace glm;
 
 class Object3D {
 public:
-    Mesh mesh;         // malha do objeto 3D
+    shared_ptr<Mesh> mesh;  // malha do objeto 3D (compartilhada entre objetos do mesmo modelo - ver ModelRegistry)
     mat4 transform;    // matriz de transformação do objeto (model matrix)
+    mat4 invTransform; // inversa da transformação (mundo -> espaço do objeto), recalculada só em updateTransform
     vec3 position;     // posição do objeto
     vec3 rotation;     // ângulos de rotação do objeto (em radianos)
     vec3 scale;        // escala do objeto
 
+    // Estado no início do passo de simulação atual (interpolação na renderização - ver System::simulate)
+    vec3 previousPosition;
+    vec3 previousRotation;
+
     bool eliminable;
+    bool collidable;    // participa das colisões com projéteis (a pista não participa)
+    int broadPhaseProxy;    // folha do objeto no AABBTree de System (-1 = fora da broad phase)
     string name;
     //, modelPath, texturePath;
     
@@ -44,8 +52,18 @@ public:
     // Carrega um objeto 3D a partir de um arquivo
     bool loadObject(string& objFilePath);
 
-    // Renderiza o objeto 3D usando o shader fornecido
-    void render(const Shader& shader) const;
+    // Guarda posição e rotação atuais antes de um passo de simulação
+    void beginStep();
+
+    // Transformação entre o passo anterior (alpha = 0) e o atual (alpha = 1)
+    mat4 interpolatedTransform(float alpha) const;
+
+    // Mesma interpolação a partir de um estado copiado (ver SceneSnapshot), sem acessar o objeto
+    static mat4 interpolateTransform(const vec3& prevPos, const vec3& pos, const vec3& prevRot, const vec3& rot,
+                                     const vec3& scl, float alpha);
+
+    // Monta a matriz de modelo a partir de posição, rotação (radianos) e escala
+    static mat4 composeTransform(const vec3& pos, const vec3& rot, const vec3& scl);
     
     // Define a posição, rotação e escala do objeto e atualiza a matriz de transformação
     void setPosition(const vec3& pos);
@@ -66,8 +84,10 @@ public:
 
     BoundingBox getTransformedBoundingBox() const;
 
-    // Testa interseção do segmento (ray) com a bounding box (retorna true se houver interseção)
-    bool rayIntersect(const vec3& rayOrigin, const vec3& rayDirection, float& distance) const;
+    // Testa o raio (em mundo) contra os triângulos da malha; retorna o triângulo mais próximo até maxDistance
+    // hit.distance é medida em unidades de mundo ao longo de rayDirection (normalizada) e hit.normal,
+    // a normal geométrica do triângulo em mundo, fica voltada contra o raio
+    bool rayIntersect(const vec3& rayOrigin, const vec3& rayDirection, float maxDistance, RayHit& hit) const;
     
     // Atualiza a matriz de transformação (model matrix) com base na posição, rotação e escala
     void updateTransform();
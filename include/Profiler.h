@@ -0,0 +1,82 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+#include <cstdint>
+#include <chrono>
+
+using namespace std;
+
+// Perfil de CPU por zonas (trechos de código marcados com PROFILE_ZONE)
+// Cada zona grava, ao sair do escopo, o nome, o início e a duração em nanossegundos no buffer circular da
+// própria thread (sem travas: só a thread dona escreve). Os buffers guardam as zonas mais recentes de cada
+// thread e são gravados sob demanda (tecla F9 ou --profile, ver System.cpp e main.cpp) no formato de eventos
+// do Chrome (chrome://tracing, ui.perfetto.dev) ou em um binário compacto.
+// Só é compilado com -DVISUALIZADOR_PROFILER (ver tasks.json): sem a opção, as macros não geram código
+// e nem avaliam os seus argumentos
+class Profiler {
+public:
+    static constexpr size_t RING_EVENTS = 1 << 15;    // zonas guardadas por thread (as mais antigas são sobrescritas)
+    static constexpr uint32_t NO_DETAIL = 0xFFFFFFFF;
+
+    // true quando compilado com -DVISUALIZADOR_PROFILER
+    static bool compiledIn();
+
+    // Nome da thread atual no arquivo gravado (principal, simulacao, trabalho N, ...)
+    static void setThreadName(const string& name);
+
+    // Texto associado a uma zona (caminho do modelo, nome do grupo): guardado uma vez, usado pelo índice
+    static uint32_t intern(const string& detail);
+
+    // Nanossegundos desde o início do programa
+    static uint64_t now() {
+        return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count();
+    }
+
+    // Grava a zona no buffer da thread atual (name deve ser um literal: só o ponteiro é guardado)
+    static void record(const char* name, uint32_t detail, uint64_t startNs, uint64_t endNs);
+
+    // Grava as zonas de todas as threads: extensão .bin = binário compacto, qualquer outra = JSON do Chrome
+    // Pode ser chamado com as outras threads em andamento (zonas sobrescritas durante a cópia são descartadas)
+    static bool write(const string& path);
+
+    // Zona: mede do construtor ao destrutor
+    class Zone {
+    public:
+        explicit Zone(const char* name, uint32_t detail = NO_DETAIL) : name(name), detail(detail), start(now()) {}
+        ~Zone() { record(name, detail, start, now()); }
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* name;
+        uint32_t detail;
+        uint64_t start;
+    };
+
+private:
+    static const chrono::steady_clock::time_point epoch;
+
+    static bool writeChromeTrace(const string& path);
+    static bool writeBinary(const string& path);
+};
+
+// Formato binário (little-endian), lido por ferramentas próprias:
+//   "VPRF", versão (u32), quantidade de textos (u32), textos (u32 tamanho + bytes, nomes e detalhes das zonas),
+//   quantidade de threads (u32), e por thread: id (u32), texto do nome (u32), quantidade de zonas (u64) e as zonas
+//   (texto do nome u32, texto do detalhe u32 ou 0xFFFFFFFF, início u64 ns, duração u64 ns)
+
+#ifdef VISUALIZADOR_PROFILER
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILER_CONCAT(zonaPerfil, __LINE__)(name)
+#define PROFILE_ZONE_DETAIL(name, detail) Profiler::Zone PROFILER_CONCAT(zonaPerfil, __LINE__)(name, Profiler::intern(detail))
+#define PROFILE_THREAD(name) Profiler::setThreadName(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_ZONE_DETAIL(name, detail) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
+
+#endif
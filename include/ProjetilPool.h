@@ -0,0 +1,86 @@
+#ifndef PROJETILPOOL_H
+#define PROJETILPOOL_H
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+using namespace std;
+using namespace glm;
+
+class JobSystem;
+
+// Conjunto de projéteis com capacidade fixa, armazenado como estrutura de arrays (SoA)
+// Cada atributo (posição x/y/z, direção x/y/z, velocidade, tempo de vida...) fica em um array contínuo,
+// de forma que a atualização percorre memória sequencial com um laço sem desvios (vetorizável pelo compilador).
+// Os slots de projéteis desativados são reaproveitados através de uma lista de slots livres:
+// disparar e desativar projéteis não aloca nem libera memória
+class ProjetilPool {
+public:
+    static const size_t DEFAULT_CAPACITY = 131072;  // suporta o teste de carga com 100 mil projéteis
+
+    // Estados de um slot (alive)
+    static const uint8_t FREE = 0;
+    static const uint8_t ACTIVE = 1;
+    static const uint8_t EXPIRING = 2;  // terminou neste passo: o último trecho ainda é varrido, depois é liberado
+
+    // Arrays SoA (índice = slot do projétil)
+    vector<float> posX, posY, posZ;     // posição
+    vector<float> prevX, prevY, prevZ;  // posição no início do último update (início do segmento varrido)
+    vector<float> dirX, dirY, dirZ;     // direção (normalizada)
+    vector<float> speed;                // velocidade
+    vector<float> lifetime;             // tempo de vida decorrido
+    vector<float> maxLifetime;          // tempo de vida máximo
+    vector<uint8_t> alive;              // FREE, ACTIVE ou EXPIRING (slot ocupado nos dois últimos)
+
+    double lastUpdateMicros;            // duração da última atualização, em microssegundos
+
+    explicit ProjetilPool(size_t capacity = DEFAULT_CAPACITY);
+
+    // Dispara um projétil; retorna o slot ocupado ou -1 se o conjunto estiver cheio
+    long spawn(const vec3& startPos, const vec3& dir, float projetilSpeed = 5.0f, float maxLife = 5.0f);
+
+    // Desativa o projétil e devolve o slot à lista de livres
+    void release(size_t slot);
+
+    // Atualiza a posição de todos os projéteis e marca como EXPIRING os que atingiram o chão (Y <= 0) ou o tempo máximo
+    // A posição anterior é guardada em prevX/Y/Z: o trecho percorrido no quadro é varrido em System::checkCollisions,
+    // inclusive o último trecho dos que expiraram, que só são liberados depois, por releaseExpired
+    // Com um JobSystem, o laço de integração é dividido em blocos de slots executados em paralelo
+    void update(float deltaTime, JobSystem* jobs = nullptr);
+
+    // Libera os projéteis EXPIRING (chamado depois da varredura das colisões do passo)
+    void releaseExpired();
+
+    // Copia a posição anterior e a atual dos projéteis ativos (ver SceneSnapshot); a renderização interpola
+    // entre as duas sem acessar o conjunto, que continua sendo atualizado pela simulação
+    void gatherPositions(vector<vec3>& previous, vector<vec3>& current) const;
+
+    // Calcula a direção do vetor de reflexão do projétil
+    void reflect(size_t slot, const vec3& normal);
+
+    vec3 position (size_t slot) const { return vec3(posX[slot], posY[slot], posZ[slot]); }
+    vec3 previousPosition(size_t slot) const { return vec3(prevX[slot], prevY[slot], prevZ[slot]); }
+    vec3 direction(size_t slot) const { return vec3(dirX[slot], dirY[slot], dirZ[slot]); }
+    void setPosition(size_t slot, const vec3& pos) { posX[slot] = pos.x; posY[slot] = pos.y; posZ[slot] = pos.z; }
+
+    bool isActive(size_t slot) const { return alive[slot] != 0; }
+
+    size_t capacity()  const { return alive.size(); }
+    size_t liveCount() const { return live; }
+    size_t highWater() const { return used; }     // slots [0, highWater) já utilizados - limite dos laços
+
+    // Desativa todos os projéteis
+    void clear();
+
+private:
+    static const size_t UPDATE_GRAIN = 16384;   // slots por bloco da atualização paralela
+
+    vector<uint32_t> freeSlots;     // slots livres abaixo de "used" (pilha)
+    size_t used;                    // número de slots já utilizados desde o último esvaziamento
+    size_t live;                    // número de projéteis ativos
+
+    void integrate(size_t begin, size_t end, float deltaTime);  // move os slots [begin, end)
+};
+
+#endif
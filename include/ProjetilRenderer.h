@@ -0,0 +1,32 @@
+#ifndef PROJETILRENDERER_H
+#define PROJETILRENDERER_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "Shader.h"
+
+using namespace std;
+using namespace glm;
+
+// Desenho de todos os projéteis com uma única chamada instanciada
+// Um único cubo (36 vértices) é compartilhado por todos os projéteis; a posição e o tamanho de cada
+// projétil vão em um buffer de instâncias (xyz = posição, w = escala) regravado a cada quadro
+class ProjetilRenderer {
+public:
+    unsigned int VAO, VBO;      // cubo compartilhado
+    unsigned int instanceVBO;   // posições/escala dos projéteis do quadro (atributo 7, uma vez por instância)
+    size_t instanceCapacity;    // número de instâncias que cabem no instanceVBO
+
+    ProjetilRenderer();
+    ~ProjetilRenderer();
+
+    // Cria o cubo compartilhado e o buffer de instâncias (chamar com o contexto OpenGL ativo)
+    void setup();
+
+    // Envia as instâncias do quadro e desenha todos os projéteis com um glDrawArraysInstanced
+    void draw(const Shader& shader, const vector<vec4>& instances);
+
+    void cleanup();
+};
+
+#endif
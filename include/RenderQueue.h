@@ -0,0 +1,66 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "UniformBuffer.h"
+
+using namespace std;
+using namespace glm;
+
+class Shader;
+
+// Item de desenho: tudo o que é preciso para desenhar um lote de material de uma malha
+struct DrawItem {
+    uint64_t key;                       // chave de ordenação (ver RenderQueue::makeKey)
+    const Shader* shader;               // programa de shader
+    unsigned int texture;               // textura difusa (0 = sem textura)
+    const UniformBuffer* materialBuffer;// buffer de materiais da malha (bloco "MaterialData")
+    size_t materialOffset;              // trecho do material do lote no buffer
+    unsigned int VAO;                   // VAO da malha (VBO + EBO)
+    unsigned int indexType;             // GL_UNSIGNED_SHORT ou GL_UNSIGNED_INT
+    unsigned int firstIndex;            // faixa do lote no EBO da malha
+    unsigned int indexCount;
+    unsigned int instanceCount;         // número de instâncias (matrizes de modelo no instanceVBO da malha)
+    vec3 objectColor;                   // cor sólida do objeto (sem textura)
+};
+
+// Fila de renderização da cena
+// A cada quadro as malhas enviam seus lotes de desenho instanciados (Mesh::submit); a fila ordena os itens por uma
+// chave de 64 bits (shader > textura > VAO > material) e os desenha pulando trocas de estado e envios
+// de uniforms repetidos em relação ao item anterior
+class RenderQueue {
+public:
+    // Estatísticas do último flush
+    struct Stats {
+        unsigned int draws;             // chamadas de desenho
+        unsigned int bindsSkipped;      // glUseProgram/glBindTexture/glBindVertexArray/glBindBufferRange evitados
+        unsigned int uniformsSkipped;   // glUniform evitados (valor igual ao já enviado)
+    };
+
+    RenderQueue();
+
+    // Descarta os itens do quadro anterior
+    void clear();
+
+    // Acrescenta um item (a chave é calculada aqui)
+    void submit(DrawItem item);
+
+    // Ordena os itens pela chave e envia os desenhos para a OpenGL
+    // "activeShader": programa que já está em uso (evita um glUseProgram repetido no primeiro item)
+    void flush(const Shader* activeShader = nullptr);
+
+    // Chave de ordenação: shader (8 bits) | textura (16 bits) | VAO (16 bits) | buffer de materiais (12 bits) |
+    // material dentro do buffer (12 bits) - os identificadores são truncados, o que só afeta o agrupamento
+    static uint64_t makeKey(const DrawItem& item);
+
+    const Stats& stats() const { return lastStats; }
+    size_t size() const { return items.size(); }
+
+private:
+    vector<DrawItem> items;
+    Stats lastStats;
+};
+
+#endif
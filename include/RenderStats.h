@@ -0,0 +1,34 @@
+#ifndef RENDERSTATS_H
+#define RENDERSTATS_H
+
+// Contadores das chamadas feitas ao driver OpenGL durante a renderização
+// Os caminhos de renderização (System, RenderQueue, UniformBuffer, ProjetilRenderer) incrementam os contadores
+// a cada chamada, e System imprime a média por quadro uma vez por segundo quando a impressão está ligada
+class RenderStats {
+public:
+    // Liga/desliga a impressão periódica das médias: desligada por padrão, ligada pela tecla R ou por --benchmark
+    static bool enabled;
+
+    // Contadores do quadro atual
+    static unsigned int uniformLookups;    // glGetUniformLocation (busca por nome no driver)
+    static unsigned int uniformUploads;    // glUniform*
+    static unsigned int stateChanges;      // glUseProgram, glBindVertexArray, glBindTexture, glActiveTexture
+    static unsigned int drawCalls;         // glDrawArrays / glDrawElements
+    static unsigned int bindsSkipped;      // trocas de estado evitadas pela fila de renderização (RenderQueue)
+    static unsigned int uniformsSkipped;   // envios de uniforms evitados pela fila de renderização
+
+    // Total de chamadas ao driver no quadro atual
+    static unsigned int driverCalls() { return uniformLookups + uniformUploads + stateChanges + drawCalls; }
+
+    // Fecha o quadro: acumula os contadores e zera os do quadro atual
+    // A cada "interval" segundos imprime a média de chamadas por quadro
+    static void endFrame(float currentTime, float interval = 1.0f);
+
+private:
+    static unsigned long long totalLookups, totalUploads, totalStateChanges, totalDrawCalls;
+    static unsigned long long totalBindsSkipped, totalUniformsSkipped;
+    static unsigned int frames;
+    static float lastReport;
+};
+
+#endif
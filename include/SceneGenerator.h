@@ -0,0 +1,56 @@
+#ifndef SCENEGENERATOR_H
+#define SCENEGENERATOR_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Geração de cargas sintéticas para os testes de escala: modelos OBJ/MTL do tamanho e formato pedidos e
+// arquivos de cena (formato do Configurador_Cena.txt) com N objetos, M alvos elimináveis e K veículos animados.
+// Usado pelo gerador de linha de comando (benchmarks/scenegen.cpp) e pelas entradas dos microbenchmarks
+class SceneGenerator {
+public:
+    struct OBJParams {
+        size_t vertices;    // quantidade aproximada de vértices (posições)
+        int arity;          // lados de cada face: 3 e 4 formam uma superfície contínua (vértices compartilhados),
+                            // 5 ou mais formam polígonos regulares independentes (k vértices próprios cada)
+        int groups;         // grupos ("g"), com as faces divididas igualmente entre eles
+        int materials;      // materiais do MTL, usados pelos grupos em rodízio
+        bool texCoords;     // gera "vt" e os índices de textura das faces
+        bool normals;       // gera "vn" e os índices de normal das faces
+        float size;         // lado da área ocupada pelo modelo (plano XZ, centrado na origem)
+        unsigned int seed;  // relevo da superfície
+
+        OBJParams() : vertices(10000), arity(4), groups(1), materials(1), texCoords(true), normals(true),
+                      size(1.0f), seed(1) {}
+    };
+
+    struct SceneParams {
+        size_t objects;             // obstáculos fixos, não elimináveis
+        size_t targets;             // alvos elimináveis
+        size_t vehicles;            // veículos animados na curva da pista
+        vector<string> objectModels;    // modelos dos obstáculos, em rodízio
+        string targetModel;
+        string vehicleModel;
+        bool track;                 // inclui a pista (referência da curva dos veículos e chão da cena)
+        float area;                 // lado da área (plano XZ) em que obstáculos e alvos são espalhados
+        unsigned int seed;          // posições e rotações
+
+        SceneParams() : objects(100), targets(10), vehicles(1), objectModels({ "models/pyramid.obj" }),
+                        targetModel("models/pyramid.obj"), vehicleModel("models/car.obj"), track(true),
+                        area(40.0f), seed(1) {}
+    };
+
+    // Grava o OBJ e o seu MTL; o "mtllib" do OBJ recebe mtlPath como está (o leitor o abre a partir do
+    // diretório atual, como nos modelos do projeto). Retorna false se algum arquivo não puder ser criado
+    static bool writeOBJ(const string& objPath, const string& mtlPath, const OBJParams& params);
+
+    // Grava um MTL com "count" materiais (material0, material1, ...)
+    static bool writeMTL(const string& path, int count);
+
+    // Grava um arquivo de cena completo: configurações do sistema do Configurador_Cena.txt e os objetos
+    static bool writeScene(const string& path, const SceneParams& params);
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef SCENESNAPSHOT_H
+#define SCENESNAPSHOT_H
+
+#include <vector>
+#include <utility>
+#include <glm/glm.hpp>
+
+using namespace std;
+using namespace glm;
+
+class Mesh;
+
+// Estado imutável da cena produzido pela simulação ao fim de um lote de passos e consumido pela renderização
+// (ver System::publishSnapshot e TripleBuffer). Guarda o passo anterior e o atual de tudo o que se move,
+// para que a renderização interpole sem acessar os objetos da simulação
+struct SceneSnapshot {
+    struct ObjectState {
+        Mesh* mesh;                 // malha do objeto (mantida viva pelo ModelRegistry até o shutdown)
+        bool animated;
+        mat4 transform;             // transformação do passo atual (usada direto pelos objetos parados)
+        vec3 previousPosition, position;
+        vec3 previousRotation, rotation;
+        vec3 scale;
+    };
+
+    vector<ObjectState> objects;
+    vector<vec3> projetilPrevious;  // posição de cada projétil ativo no passo anterior
+    vector<vec3> projetilCurrent;   // e no passo atual
+
+    double stateTime;               // instante (relógio do System) a que corresponde o passo atual
+    unsigned long tick;             // System::simulationTick do passo atual
+
+    // Custo do passo atual, para o relatório periódico impresso pela thread principal (System::reportSimulation)
+    size_t liveProjeteis;
+    double projetilMicros;                      // ProjetilPool::update
+    double collisionMicros;                     // System::checkCollisions
+    vector<pair<const char*, double>> tasks;    // tarefas do grafo do passo: nome e duração (us)
+    unsigned int workers;                       // threads de trabalho do JobSystem
+
+    SceneSnapshot() : stateTime(0.0), tick(0), liveProjeteis(0), projetilMicros(0.0), collisionMicros(0.0), workers(0) {}
+};
+
+#endif
@@ -12,13 +12,41 @@ using namespace glm;
 class Shader {
 public:
     unsigned int ID;
+
+    // Uniforms avulsos usados pelos shaders do sistema
+    // As localizações são resolvidas uma única vez, logo após a linkagem (resolveUniforms),
+    // e acessadas pelo enum - sem busca por nome no driver durante a renderização
+    // Câmera, luz, atenuação, fog e material ficam nos blocos de uniforms (ver UniformBuffer.h)
+    // e as matrizes de modelo nos buffers de instâncias (ver Mesh::submit e ProjetilRenderer)
+    enum Uniform {
+        HAS_DIFFUSE_MAP, DIFFUSE_MAP,           // textura do material
+        OBJECT_COLOR, IS_PROJECTILE,            // objetos e projéteis
+        UNIFORM_COUNT
+    };
+
+    // Liga/desliga o uso das localizações pré-resolvidas
+    // Desligado, cada envio volta a chamar glGetUniformLocation (para comparar as chamadas por quadro)
+    static bool cacheUniforms;
     
     Shader();
     ~Shader();
 
     bool loadShaders(const string& vertexSource, const string& fragmentSource);
+
+    // Localização do uniform no programa (-1 se o shader não usa o uniform)
+    int location(Uniform uniform) const;
+
+    // Envio de uniforms pelo enum (contabilizados em RenderStats)
+    void setInt  (Uniform uniform, int value) const;
+    void setFloat(Uniform uniform, float value) const;
+    void setVec3 (Uniform uniform, const vec3& value) const;
+    void setMat4 (Uniform uniform, const mat4& value) const;
     
 private:
+    int uniformLocations[UNIFORM_COUNT];    // localizações resolvidas após a linkagem
+
+    void resolveUniforms();
+
     unsigned int compileShader(const string& source, GLenum shaderType) const;
     bool checkCompileErrors(unsigned int shader, const string& type) const;
     void cleanup();
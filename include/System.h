@@ -2,8 +2,12 @@
 #define SYSTEM_H
 
 #include <vector>
+#include <map>
 #include <memory>
 #include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
 #include <glad/glad.h>  // biblioteca de funções baseada nas definições/especificações OPENGL
                         // Incluir antes de outros que requerem OpenGL (como GLFW)
 #include <GLFW/glfw3.h> // biblioteca de funções para criação da janela no Windows
@@ -13,8 +17,16 @@
 
 #include "Camera.h"
 #include "Shader.h"
+#include "UniformBuffer.h"
+#include "RenderQueue.h"
 #include "Object3D.h"
-#include "Projetil.h"
+#include "AABBTree.h"
+#include "ProjetilPool.h"
+#include "ProjetilRenderer.h"
+#include "SceneSnapshot.h"
+#include "TripleBuffer.h"
+#include "JobSystem.h"
+#include "AssetLoader.h"
 
 using namespace std;	// Para não precisar digitar std:: na frente de comandos da biblioteca
 using namespace glm;	// Para não precisar digitar  na frente de comandos da biblioteca
@@ -36,19 +48,101 @@ struct ObjectInfo {
                           // Mtl -> Textura -> id da textura -> grupo do objeto -> malha do objeto  
 };
 
+// Pedido da entrada (thread principal) para a simulação, aplicado no início do próximo passo
+struct SimulationCommand {
+    enum Type { DISPARO, DISPARO_EM_MASSA, ALTERNAR_NUCLEOS, BENCHMARK_JOBS, ADICIONAR_OBJETO };
+
+    Type type;
+    vec3 origem;        // posição e direção da câmera no momento do pedido
+    vec3 direcao;
+    size_t quantidade;  // projéteis do disparo em massa / objetos do benchmark
+    Object3D* objeto;   // objeto recém carregado que passa para a cena (a simulação assume a posse)
+};
+
+// Opções da execução roteirizada (linha de comando, ver main.cpp e System::runScripted)
+struct ScriptedRunOptions {
+    bool enabled;           // execução roteirizada em vez do laço interativo (--headless ou --benchmark)
+    bool headless;          // sem janela
+    string contextApi;      // "egl" (EGL sem superfície do Mesa) ou "osmesa"
+    string cameraPath;      // pontos "x y z" percorridos pela câmera (curva de animação, nas coordenadas da pista); vazio = câmera fixa
+    string scriptPath;      // roteiro de disparos (ver System::loadFiringScript); vazio = sem disparos
+    string benchmarkPath;   // relatório JSON com a duração dos quadros e de cada etapa (vazio = só o resumo no console)
+    int frames;             // quadros renderizados
+    string dumpDirectory;   // grava os quadros em PNG neste diretório (vazio = sem imagens)
+    int dumpEvery;          // grava um a cada dumpEvery quadros
+    string statsPath;       // CSV com a duração de cada quadro
+    unsigned int seed;      // semente de rand() (espalhamento dos disparos em massa)
+
+    ScriptedRunOptions() : enabled(false), headless(false), contextApi("egl"), frames(600), dumpEvery(1), seed(1) {}
+};
+
+// Disparo do roteiro de uma execução roteirizada, feito a partir da câmera no início do quadro "frame"
+struct ScriptedShot {
+    int frame;
+    size_t quantidade;  // 1 = tiro, mais de 1 = disparo em massa
+};
+
 class System {
 public:
     GLFWwindow* window; // Janela principal do sistema OpenGL
     Object3D* sceneObject; // Objeto atualmente selecionado (para manipulação)
+    string scenePath;      // arquivo de configuração da cena (padrão "Configurador_Cena.txt", ou --scene)
+    string profilePath;    // perfil de CPU gravado com F9 e ao sair (padrão "perfil_cpu.json", ou --profile; ver Profiler)
+
+    // Execução sem janela (--headless, ver runScripted): plataforma "null" da GLFW 3.4 (sem servidor gráfico) com contexto
+    // EGL sem superfície ou OSMesa - o Mesa llvmpipe renderiza na CPU, sem GPU - e desenho em um framebuffer
+    // próprio. O relógio da simulação e da interpolação passa a ser o dos quadros (fixedClock)
+    bool headless;
+    string headlessContext;         // "egl" ou "osmesa"
+    GLuint offscreenFBO;            // framebuffer de desenho (cor + profundidade em renderbuffers)
+    GLuint offscreenColor, offscreenDepth;
+    double fixedClock;              // tempo do quadro em execução sem janela (< 0 = relógio real)
 
     // Configurações da janela
     static const unsigned int SCREEN_WIDTH = 1024;
     static const unsigned int SCREEN_HEIGHT = 768;
 
     // Temporização
-    float deltaTime;
+    float deltaTime;    // duração do último quadro (câmera e entrada)
     float lastFrame;    
 
+    // Simulação em passo fixo (ver simulate): animações, projéteis e colisões avançam sempre fixedStep segundos,
+    // independentemente da taxa de quadros; a renderização interpola entre os dois últimos passos
+    float fixedStep;            // duração do passo (1 / SIMULATION hz do arquivo de configuração)
+    int maxStepsPerFrame;       // limite de passos de recuperação por quadro
+    float accumulator;          // tempo de quadro ainda não simulado
+    unsigned long simulationTick;   // passos executados desde o início (base para replays determinísticos)
+
+    // Simulação e renderização em threads separadas (SIMULATION ... threads = 1): a thread de simulação publica
+    // um SceneSnapshot ao fim de cada lote de passos e a renderização (thread principal, dona do contexto OpenGL)
+    // desenha o mais recente, sem que uma espere pela outra. Com threads = 0 o laço principal chama simulate
+    bool simulationThreaded;
+    TripleBuffer<SceneSnapshot> snapshots;
+    thread simulationThread;
+    atomic<bool> simulationRunning;
+    mutex commandMutex;                         // protege pendingCommands
+    vector<SimulationCommand> pendingCommands;  // pedidos da entrada ainda não aplicados
+    vector<SimulationCommand> activeCommands;   // pedidos sendo aplicados (lado da simulação)
+
+    // Threads de trabalho (JOBS do arquivo de configuração) usadas pelas duas threads acima: cada passo de
+    // simulação é um grafo de tarefas (animações e projéteis em paralelo, depois colisões) e a renderização
+    // divide entre elas as transformações e o descarte por frustum dos objetos
+    JobSystem jobs;
+    TaskGraph simulationGraph;
+    float stepDelta;            // dt do passo em execução no grafo
+    int animationTask, projectileTask, collisionTask;   // tarefas do grafo (duração de cada etapa no benchmark)
+
+    // Carregamento da cena em segundo plano (ASSETS do arquivo de configuração): os objetos lidos do arquivo
+    // esperam em pendingObjects pela malha do seu modelo; a cada quadro processLoadedAssets envia à OpenGL
+    // as malhas prontas, até uploadBudgetBytes por quadro, e passa os objetos para a simulação
+    AssetLoader assetLoader;
+    int loaderThreads;
+    size_t uploadBudgetBytes;
+    map<string, vector<unique_ptr<Object3D>>> pendingObjects;  // caminho do modelo -> objetos que o usam
+    double loadStartTime;       // início do carregamento (clockSeconds)
+    size_t objectsLoaded;       // objetos já passados para a simulação
+    bool loadReported;          // resumo do carregamento já impresso
+
     System();   // Construtor padrão
 
     ~System();  // Destrutor padrão
@@ -58,11 +152,19 @@ public:
     bool loadShaders();
     bool loadSceneObjects();
     void processInput();
+    void processLoadedAssets();
     void render();
+    void reportSimulation();    // custo do passo de simulação, impresso uma vez por segundo (thread principal)
     void shutdown();
+    bool runScripted(const ScriptedRunOptions& options);
     
     Camera camera;      // câmera do sistema
     Shader mainShader;  // shader unificado para objetos da cena e projéteis
+
+    UniformBuffer frameUniforms;    // bloco "FrameData": câmera, luz, atenuação e fog (um envio por quadro)
+    UniformBuffer defaultMaterial;  // bloco "MaterialData" usado pelos projéteis
+
+    RenderQueue renderQueue;        // fila de desenho dos objetos da cena, ordenada por estado a cada quadro
     
     // Propriedades de iluminação
     vec3 lightPos;      // Posição da luz na cena
@@ -80,22 +182,74 @@ public:
     float fogEnd;            // Fim do fog (linear)
     int fogType;             // 0=linear, 1=exponencial, 2=exponencial²
     bool fogEnabled;         // Flag para ligar/desligar o fog
+
+    // Transformação da pista (posição, rotação, escala), lida da cena: aplicada às curvas dos veículos
+    // e ao caminho da câmera da execução roteirizada, que usam as coordenadas do modelo da pista
+    vec3 trackPosition;
+    vec3 trackRotation;
+    vec3 trackScale;
     
 
     // Cria um vetor para armazenar a coleção dos objetos 3D da cena
     vector<unique_ptr<Object3D>> sceneObjects;
 
-    // Cria um vetor para armazenar a coleção dos projéteis disparados
-    vector<unique_ptr<Projetil>> projeteis;
+    // Broad phase das colisões: caixas (em mundo) dos objetos colidíveis da cena
+    AABBTree broadPhase;
+    double lastCollisionMicros;     // duração do último checkCollisions, em microssegundos
+    double lastSimulationReport;    // tempo simulado do último relatório de reportSimulation (thread principal)
+
+    // Impactos resolvidos desde o início (ver resolveImpact); quietImpacts omite a mensagem de cada impacto,
+    // para que a execução roteirizada meça as colisões e não a escrita no console
+    size_t projectilesSpawned;      // projéteis disparados desde o início (ver applyCommands)
+    size_t impactBounces;
+    size_t impactEliminations;
+    bool quietImpacts;
+
+    // Pacotes de raios do passo atual e o impacto mais próximo de cada raio (fase estreita em paralelo)
+    vector<RayPacket> collisionPackets;
+    vector<size_t> collisionSlots;          // projétil de cada raio (PACKET_SIZE por pacote)
+    vector<Object3D*> collisionTargets;
+    vector<RayHit> collisionHits;
+    vector<Object3D*> collisionEliminated;  // objetos eliminados no passo (já removidos da cena)
+
+    // Conjunto (SoA, capacidade fixa) dos projéteis disparados
+    ProjetilPool projeteis;
+
+    ProjetilRenderer projetilRenderer;  // cubo compartilhado e buffer de instâncias dos projéteis
+    vector<vec4> projetilInstances;     // posição/escala dos projéteis ativos no quadro atual
+    vector<mat4> objectTransforms;      // transformação interpolada de cada objeto do snapshot no quadro atual
+    vector<uint8_t> objectVisible;      // 1 = objeto dentro do frustum da câmera
     
     // Entrada
     bool firstMouse;
     float lastX, lastY;
 
-    void disparo();
-    void updateProjeteis();
-    void updateAnimations();
+    // Retornam os projéteis realmente disparados (menos que o pedido quando o conjunto está cheio)
+    size_t disparo(const vec3& origem, const vec3& direcao);
+    size_t disparoEmMassa(const vec3& origem, const vec3& direcao, size_t quantidade);
+    void pushCommand(const SimulationCommand& command);
+    void applyCommands();
+    void startSimulation();
+    void stopSimulation();
+    void simulationLoop();
+    void publishSnapshot(double stateTime);
+    double clockSeconds() const;
+    bool createOffscreenTarget();
+    void destroyOffscreenTarget();
+    bool loadCameraPath(const string& path, vector<vec3>& points);
+    void placeCameraOnPath(const vector<vec3>& points, float t);
+    bool loadFiringScript(const string& path, vector<ScriptedShot>& shots);
+    bool dumpFrame(const string& path);
+    void simulate(float frameTime);
+    void stepSimulation(float dt);
+    void updateProjeteis(float dt);
+    void updateAnimations(float dt);
+    void benchmarkJobs(size_t quantidade);
     void checkCollisions();
+    void queryCollisionPacket(const RayPacket& pacote, const size_t* slots, Object3D** atingido, RayHit* impacto);
+    Object3D* sweepSegment(const vec3& origem, const vec3& direcao, float percurso, RayHit& impacto);
+    Object3D* resolveImpact(size_t projetil, vec3 origem, float percurso, Object3D* atingido, RayHit impacto);
+    void removeSceneObject(Object3D* object);
     
     // Callbacks
     static void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -103,7 +257,7 @@ public:
     static void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
     
     // Funções auxiliares
-    // Carrega configurações do sistema (câmera, luz, fog) do arquivo de configuração "Configurador_Cena.txt"
+    // Carrega configurações do sistema (câmera, luz, fog) do arquivo de configuração (scenePath)
     bool loadSystemConfiguration();
 
     // Lê o arquivo de configuração dos objetos da cena e retorna um vetor de ObjectInfo
@@ -3,10 +3,24 @@
 
 #include <string>
 #include <map>
+#include <memory>
 #include <glad/glad.h>
 
 using namespace std;
 
+// Imagem decodificada (stb_image) ainda não enviada à OpenGL
+// Preenchida em qualquer thread por Texture::decode; os pixels são liberados no envio (Texture::upload)
+struct TextureImage {
+    struct PixelDeleter { void operator()(unsigned char* pixels) const; };   // stbi_image_free
+
+    int width, height, channels;
+    unique_ptr<unsigned char[], PixelDeleter> pixels;
+
+    TextureImage() : width(0), height(0), channels(0) {}
+
+    size_t bytes() const { return (size_t)width * height * channels; }
+};
+
 class Texture {
 private:
     // Cache de texturas já carregadas (path -> textureID)
@@ -16,6 +30,12 @@ public:
     // Carrega uma textura a partir de um arquivo e retorna o ID da textura OpenGL
     // Se a textura já foi carregada, retorna o ID do cache de texturas
     static unsigned int loadTexture(const string& path);
+
+    // Carregamento em duas etapas (ver AssetLoader): decode lê e decodifica o arquivo sem usar a OpenGL
+    // (pode rodar em qualquer thread); upload cria a textura na thread do contexto OpenGL, usando o cache
+    // (se o caminho já foi enviado, retorna o ID existente e só descarta a imagem)
+    static bool decode(const string& path, TextureImage& image);
+    static unsigned int upload(const string& path, TextureImage& image);
     
     // Limpa o cache de texturas (opcional, para liberar memória)
     static void clearCache();
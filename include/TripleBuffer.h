@@ -0,0 +1,43 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+// Buffer triplo sem travas entre um produtor e um consumidor (ex.: thread de simulação -> thread de renderização)
+// O produtor escreve sempre no seu buffer (writeBuffer) e o publica; o consumidor lê sempre o mais recente
+// publicado (read). Nenhum dos dois espera pelo outro: um buffer fica com cada thread e o terceiro é trocado
+// atomicamente entre eles, com um bit indicando se ainda não foi lido
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : writeIndex(0), readIndex(1), middle(2) {}
+
+    // Buffer do produtor (não é visto pelo consumidor até publish)
+    T& writeBuffer() { return buffers[writeIndex]; }
+
+    // Publica o buffer do produtor e passa a escrever no que estava no meio
+    void publish() {
+        unsigned int anterior = middle.exchange(writeIndex | FRESH, std::memory_order_acq_rel);
+        writeIndex = anterior & INDEX_MASK;
+    }
+
+    // Troca para o buffer publicado mais recente, se houver um novo, e o retorna
+    const T& read() {
+        if (middle.load(std::memory_order_acquire) & FRESH) {
+            unsigned int anterior = middle.exchange(readIndex, std::memory_order_acq_rel);
+            readIndex = anterior & INDEX_MASK;
+        }
+        return buffers[readIndex];
+    }
+
+private:
+    static const unsigned int FRESH = 4;        // bit: buffer do meio publicado e ainda não lido
+    static const unsigned int INDEX_MASK = 3;
+
+    T buffers[3];
+    unsigned int writeIndex;            // usado só pelo produtor
+    unsigned int readIndex;             // usado só pelo consumidor
+    std::atomic<unsigned int> middle;   // índice do buffer do meio + bit FRESH
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef UNIFORMBUFFER_H
+#define UNIFORMBUFFER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+using namespace std;
+using namespace glm;
+
+// Pontos de ligação (binding points) dos blocos de uniforms, compartilhados por todos os programas de shader
+// (Shader::resolveUniforms liga os blocos "FrameData" e "MaterialData" de cada programa a estes pontos)
+enum UniformBinding {
+    FRAME_BINDING    = 0,
+    MATERIAL_BINDING = 1
+};
+
+// Estado por quadro: câmera, luz, atenuação e fog - espelha o bloco "FrameData" (layout std140) dos shaders
+// No std140 um vec3 ocupa 16 bytes; por isso os vetores são vec4 (w sem uso) e os escalares
+// vêm agrupados de 4 em 4 ao final
+struct FrameUniforms {
+    mat4  projection;       // offset   0
+    mat4  view;             // offset  64
+    vec4  lightPos;         // offset 128 (xyz)
+    vec4  lightIntensity;   // offset 144 (rgb)
+    vec4  viewPos;          // offset 160 (xyz)
+    vec4  fogColor;         // offset 176 (rgb)
+    float attConstant;      // offset 192
+    float attLinear;        // offset 196
+    float attQuadratic;     // offset 200
+    float fogDensity;       // offset 204
+    float fogStart;         // offset 208
+    float fogEnd;           // offset 212
+    int   fogEnabled;       // offset 216
+    int   fogType;          // offset 220
+};
+static_assert(sizeof(FrameUniforms) == 224, "FrameUniforms deve seguir o layout std140 do bloco FrameData");
+
+// Propriedades do material - espelha o bloco "MaterialData" (layout std140) dos shaders
+// Cada vec3 é seguido de um float, que ocupa o quarto componente do seu espaço de 16 bytes
+struct MaterialUniforms {
+    vec3  Ka;       // offset  0
+    float Ns;       // offset 12
+    vec3  Kd;       // offset 16
+    float pad0;     // offset 28
+    vec3  Ks;       // offset 32
+    float pad1;     // offset 44
+};
+static_assert(sizeof(MaterialUniforms) == 48, "MaterialUniforms deve seguir o layout std140 do bloco MaterialData");
+
+// Buffer de uniforms (UBO) da OpenGL
+class UniformBuffer {
+public:
+    unsigned int ID;
+    size_t size;    // tamanho do buffer em bytes
+
+    UniformBuffer();
+    ~UniformBuffer();
+
+    // Cria o buffer com "bufferSize" bytes (conteúdo inicial opcional)
+    void create(size_t bufferSize, const void* data = nullptr, GLenum usage = GL_DYNAMIC_DRAW);
+
+    // Regrava "dataSize" bytes a partir de "offset" - uma única escrita no buffer
+    void update(const void* data, size_t dataSize, size_t offset = 0) const;
+
+    // Liga o buffer inteiro, ou apenas um trecho dele, a um ponto de ligação dos blocos de uniforms
+    void bind(UniformBinding binding) const;
+    void bindRange(UniformBinding binding, size_t offset, size_t rangeSize) const;
+
+    // Alinhamento exigido pela OpenGL para o início de cada trecho ligado com bindRange
+    static size_t offsetAlignment();
+
+    void cleanup();
+
+private:
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+};
+
+#endif
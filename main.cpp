@@ -12,17 +12,89 @@
 ***/
 
 #include <iostream>
+#include <string>
+#include <cstdlib>
 #include "System.h"
+#include "RenderStats.h"
+#include "Profiler.h"
 
 using namespace std;
 
-int main() {
+static void printUsage() {
+    cout << "Uso: visualizador3d [--scene arquivo] [--headless] [--benchmark relatorio.json] [opcoes]" << endl;
+    cout << "  --scene arquivo        arquivo de configuracao da cena (padrao Configurador_Cena.txt)" << endl;
+    cout << "  --headless             execucao roteirizada sem janela (EGL sem superficie ou OSMesa, ex.: Mesa llvmpipe)" << endl;
+    cout << "  --benchmark arquivo    execucao roteirizada sem limite de quadros; grava o relatorio JSON" << endl;
+    cout << "                         e imprime as chamadas ao driver por quadro (RenderStats)" << endl;
+    cout << "  --context egl|osmesa   API do contexto sem janela (padrao egl)" << endl;
+    cout << "  --camera-path arquivo  pontos \"x y z\" (curva nas coordenadas da pista) percorridos pela camera" << endl;
+    cout << "  --script arquivo       roteiro de disparos (\"quadro TIRO\" ou \"quadro RAJADA quantidade\")" << endl;
+    cout << "  --frames N             quadros renderizados (padrao 600)" << endl;
+    cout << "  --dump-png diretorio   grava os quadros em PNG" << endl;
+    cout << "  --dump-every N         grava um a cada N quadros (padrao 1)" << endl;
+    cout << "  --stats arquivo        grava a duracao de cada quadro (CSV)" << endl;
+    cout << "  --seed N               semente dos numeros aleatorios (padrao 1)" << endl;
+    cout << "  --profile arquivo      grava o perfil de CPU ao sair (.json = Chrome trace, .bin = binario compacto;" << endl;
+    cout << "                         requer compilacao com -DVISUALIZADOR_PROFILER)" << endl;
+}
+
+// Lê as opções da linha de comando; false se alguma for desconhecida ou estiver sem valor
+static bool parseArguments(int argc, char* argv[], string& scenePath, string& profilePath, ScriptedRunOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        string opcao = argv[i];
+        if (opcao == "--headless") { options.enabled = options.headless = true; continue; }
+
+        if (i + 1 >= argc) {
+            cerr << "Opcao desconhecida ou sem valor: " << opcao << endl;
+            return false;
+        }
+        string valor = argv[++i];
+
+        if      (opcao == "--scene")       { scenePath = valor; }
+        else if (opcao == "--context")     { options.contextApi = valor; }
+        else if (opcao == "--benchmark")   { options.benchmarkPath = valor; options.enabled = true; RenderStats::enabled = true; }
+        else if (opcao == "--camera-path") { options.cameraPath = valor; }
+        else if (opcao == "--script")      { options.scriptPath = valor; }
+        else if (opcao == "--frames")      { options.frames = atoi(valor.c_str()); }
+        else if (opcao == "--dump-png")    { options.dumpDirectory = valor; }
+        else if (opcao == "--dump-every")  { options.dumpEvery = atoi(valor.c_str()); }
+        else if (opcao == "--stats")       { options.statsPath = valor; }
+        else if (opcao == "--seed")        { options.seed = (unsigned int)strtoul(valor.c_str(), nullptr, 10); }
+        else if (opcao == "--profile")     { profilePath = valor; }
+        else {
+            cerr << "Opcao desconhecida: " << opcao << endl;
+            return false;
+        }
+    }
+
+    if (options.contextApi != "egl" && options.contextApi != "osmesa") {
+        cerr << "Contexto sem janela invalido: " << options.contextApi << " (use egl ou osmesa)" << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
     cout << endl;
     cout << "    Visualizador de Modelos 3D - CGR    " << endl;
     cout << endl;
 
+    PROFILE_THREAD("principal");
+
     System system;  // Instancia o sistema (onde teremos janela, OpenGL, Shaders, cena, etc)
 
+    // Opções da linha de comando: arquivo da cena e execução roteirizada, com ou sem janela (ver System::runScripted)
+    // O perfil de CPU só é gravado ao sair se --profile for informado (F9 grava a qualquer momento, ver Profiler)
+    ScriptedRunOptions runOptions;
+    string profilePath;
+    if (!parseArguments(argc, argv, system.scenePath, profilePath, runOptions)) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+    if (!profilePath.empty()) { system.profilePath = profilePath; }
+    system.headless = runOptions.headless;
+    system.headlessContext = runOptions.contextApi;
+
     // inicializa a GLFW (janela, contexto, callbacks, etc - na apresentação ver System.cpp)
     if (!system.initializeGLFW()) {
         cerr << "Falha ao inicializar GLFW" << endl;
@@ -55,36 +127,65 @@ int main() {
     cout << "Sistema inicializado com sucesso" << endl;
     cout << endl;
 
+    // Execução roteirizada: quadros de duração fixa, caminho da câmera e disparos do roteiro no lugar
+    // da entrada do usuário, até o número pedido (ver System.cpp)
+    if (runOptions.enabled) {
+        bool concluida = system.runScripted(runOptions);
+        if (!profilePath.empty()) { Profiler::write(profilePath); }
+        system.shutdown();
+        return concluida ? 0 : EXIT_FAILURE;
+    }
+
     cout << "Controles:" << endl;
     cout << "  WASD/Setas: Mover camera" << endl;
     cout << "  Mouse: Olhar ao redor" << endl;
     cout << "  Scroll: Zoom" << endl;
     cout << "  ESPAÇO: Atirar" << endl;
+    cout << "  P: Teste de carga (100 mil projeteis)" << endl;
+    cout << "  U: Liga/desliga o cache de uniforms" << endl;
+    cout << "  R: Liga/desliga a impressao das chamadas ao driver por quadro e do custo da simulacao" << endl;
+    cout << "  K: Alterna os nucleos SIMD das colisoes (AVX/SSE/escalar)" << endl;
+    cout << "  J: Benchmark do JobSystem (10 mil objetos animados, 1/2/4/8 threads)" << endl;
+    cout << "  F9: Grava o perfil de CPU (" << system.profilePath << ", ver Profiler)" << endl;
     cout << "  ESC: Sair" << endl;
     cout << endl;
 
+    // Publica o estado inicial da cena e inicia a thread de simulação (ver System.cpp)
+    system.startSimulation();
+
     // Main loop - game loop
     while (!glfwWindowShouldClose(system.window)) {
-        
+        PROFILE_ZONE("quadro");
+
         float currentFrame = glfwGetTime(); // Tempo atual em segundos desde que a GLFW foi inicializada 
         system.deltaTime = currentFrame - system.lastFrame; // Tempo entre frames para movimentação dos
         system.lastFrame = currentFrame;                    // projéteis e demais objetos animados
 
         system.processInput();  // Processa entrada do usuário (teclado, mouse, etc - ver System.cpp)
 
-        system.updateAnimations();  // Atualiza animações dos objetos (ver System.cpp)
+        // Animações, projéteis e colisões em passos fixos (ver System.cpp); com a simulação em thread própria
+        // o laço principal só renderiza o snapshot mais recente
+        if (!system.simulationThreaded) {
+            system.simulate(system.deltaTime);
+        }
 
-        system.updateProjeteis();   // Atualiza posição dos projéteis (ver System.cpp)
-
-        system.checkCollisions();   // Verifica colisões entre projéteis e objetos da cena (ver System.cpp)
+        system.processLoadedAssets();   // Envia à GPU os modelos carregados em segundo plano (ver System.cpp)
 
         system.render();        // Renderiza a cena (ver System.cpp)
 
-        glfwSwapBuffers(system.window); // Troca os buffers da janela (ver System.cpp)
+        RenderStats::endFrame(currentFrame);    // Fecha o quadro e imprime as chamadas ao driver por quadro (ver RenderStats.cpp)
+        system.reportSimulation();              // e o custo dos passos de simulação (ver System.cpp)
+
+        {
+            PROFILE_ZONE("glfwSwapBuffers");
+            glfwSwapBuffers(system.window); // Troca os buffers da janela (ver System.cpp)
+        }
 
         glfwPollEvents();   // Processa eventos da janela (teclado, mouse, etc) (ver System.cpp)
     }
 
+    if (!profilePath.empty()) { Profiler::write(profilePath); }
+
     system.shutdown(); // Limpa e finaliza o sistema
 
     return 0;
@@ -0,0 +1,246 @@
+#include "AABBTree.h"
+
+
+AABBTree::AABBTree() : root(NULL_NODE), freeList(NULL_NODE), leaves(0) {}
+
+
+// Margem da caixa engordada: proporcional ao tamanho do objeto, para que o veículo animado
+// percorra alguns quadros antes de precisar reinserir sua folha
+static BoundingBox fatten(const BoundingBox& box) {
+    vec3 margin = box.size() * 0.1f + vec3(0.05f);
+    BoundingBox fat;
+    fat.pontoMinimo = box.pontoMinimo - margin;
+    fat.pontoMaximo = box.pontoMaximo + margin;
+    return fat;
+}
+
+
+int AABBTree::insert(const BoundingBox& box, void* userData) {
+    int leaf = allocateNode();
+    nodes[leaf].box = fatten(box);
+    nodes[leaf].userData = userData;
+    nodes[leaf].height = 0;
+
+    insertLeaf(leaf);
+    leaves++;
+    return leaf;
+}
+
+
+void AABBTree::remove(int proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    leaves--;
+}
+
+
+bool AABBTree::move(int proxy, const BoundingBox& box) {
+    if (contains(nodes[proxy].box, box)) return false;  // ainda dentro da caixa engordada: nada a fazer
+
+    removeLeaf(proxy);
+    nodes[proxy].box = fatten(box);
+    insertLeaf(proxy);
+    return true;
+}
+
+
+void AABBTree::clear() {
+    nodes.clear();
+    root = NULL_NODE;
+    freeList = NULL_NODE;
+    leaves = 0;
+}
+
+
+int AABBTree::allocateNode() {
+    if (freeList == NULL_NODE) {    // sem nós livres: cresce o vetor
+        nodes.push_back(Node());
+        freeList = (int)nodes.size() - 1;
+        nodes[freeList].parent = NULL_NODE;
+    }
+
+    int node = freeList;
+    freeList = nodes[node].parent;
+
+    nodes[node].userData = nullptr;
+    nodes[node].parent = NULL_NODE;
+    nodes[node].left = NULL_NODE;
+    nodes[node].right = NULL_NODE;
+    nodes[node].height = 0;
+    return node;
+}
+
+
+void AABBTree::freeNode(int node) {
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+
+// Insere a folha ao lado do irmão que menos aumenta a área (superfície) total da árvore
+void AABBTree::insertLeaf(int leaf) {
+    if (root == NULL_NODE) {
+        root = leaf;
+        nodes[root].parent = NULL_NODE;
+        return;
+    }
+
+    // Desce pela árvore escolhendo, em cada nó, o caminho mais barato
+    const BoundingBox leafBox = nodes[leaf].box;
+    int index = root;
+    while (!nodes[index].isLeaf()) {
+        int left = nodes[index].left;
+        int right = nodes[index].right;
+
+        float nodeArea = area(nodes[index].box);
+        float combinedArea = area(merge(nodes[index].box, leafBox));
+
+        float cost = 2.0f * combinedArea;                       // custo de criar um novo pai para este nó e a folha
+        float inheritance = 2.0f * (combinedArea - nodeArea);   // custo mínimo repassado aos descendentes
+
+        float costLeft = area(merge(leafBox, nodes[left].box)) + inheritance;
+        if (!nodes[left].isLeaf()) { costLeft -= area(nodes[left].box); }
+
+        float costRight = area(merge(leafBox, nodes[right].box)) + inheritance;
+        if (!nodes[right].isLeaf()) { costRight -= area(nodes[right].box); }
+
+        if (cost < costLeft && cost < costRight) break;
+
+        index = costLeft < costRight ? left : right;
+    }
+
+    // Cria um novo pai para o irmão escolhido e a folha
+    int sibling = index;
+    int oldParent = nodes[sibling].parent;
+    int newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].box = merge(leafBox, nodes[sibling].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].left = sibling;
+    nodes[newParent].right = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE) {
+        root = newParent;
+    } else if (nodes[oldParent].left == sibling) {
+        nodes[oldParent].left = newParent;
+    } else {
+        nodes[oldParent].right = newParent;
+    }
+
+    refit(nodes[leaf].parent);
+}
+
+
+// Retira a folha da árvore; o irmão ocupa o lugar do pai, que é liberado
+void AABBTree::removeLeaf(int leaf) {
+    if (leaf == root) {
+        root = NULL_NODE;
+        return;
+    }
+
+    int parent = nodes[leaf].parent;
+    int grandParent = nodes[parent].parent;
+    int sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+    if (grandParent == NULL_NODE) {
+        root = sibling;
+        nodes[sibling].parent = NULL_NODE;
+    } else {
+        if (nodes[grandParent].left == parent) { nodes[grandParent].left = sibling; }
+        else                                   { nodes[grandParent].right = sibling; }
+        nodes[sibling].parent = grandParent;
+        refit(grandParent);
+    }
+
+    freeNode(parent);
+    nodes[leaf].parent = NULL_NODE;
+}
+
+
+void AABBTree::refit(int index) {
+    while (index != NULL_NODE) {
+        index = balance(index);
+
+        int left = nodes[index].left;
+        int right = nodes[index].right;
+        nodes[index].height = 1 + std::max(nodes[left].height, nodes[right].height);
+        nodes[index].box = merge(nodes[left].box, nodes[right].box);
+
+        index = nodes[index].parent;
+    }
+}
+
+
+// Rotação simples quando a diferença de altura entre os filhos de "a" passa de 1
+// Retorna o nó que passou a ocupar a posição de "a"
+int AABBTree::balance(int a) {
+    Node& A = nodes[a];
+    if (A.isLeaf() || A.height < 2) return a;
+
+    int b = A.left;
+    int c = A.right;
+    int diff = nodes[c].height - nodes[b].height;
+
+    if (diff > 1 || diff < -1) {
+        // "up" é o filho mais alto (sobe para o lugar de "a"); "down" o irmão que permanece sob "a"
+        bool rightHeavy = diff > 1;
+        int up = rightHeavy ? c : b;
+        Node& U = nodes[up];
+        int f = U.left;
+        int g = U.right;
+
+        // "up" assume o lugar de "a"
+        U.left = a;
+        U.parent = A.parent;
+        A.parent = up;
+
+        if (U.parent == NULL_NODE) {
+            root = up;
+        } else if (nodes[U.parent].left == a) {
+            nodes[U.parent].left = up;
+        } else {
+            nodes[U.parent].right = up;
+        }
+
+        // O neto mais alto fica com "up"; o outro desce para "a"
+        int keep = nodes[f].height > nodes[g].height ? f : g;
+        int give = keep == f ? g : f;
+        U.right = keep;
+        if (rightHeavy) { A.right = give; }
+        else            { A.left  = give; }
+        nodes[give].parent = a;
+
+        int other = rightHeavy ? A.left : A.right;
+        A.box = merge(nodes[other].box, nodes[give].box);
+        A.height = 1 + std::max(nodes[other].height, nodes[give].height);
+        U.box = merge(A.box, nodes[keep].box);
+        U.height = 1 + std::max(A.height, nodes[keep].height);
+
+        return up;
+    }
+
+    return a;
+}
+
+
+BoundingBox AABBTree::merge(const BoundingBox& a, const BoundingBox& b) {
+    BoundingBox box;
+    box.pontoMinimo = min(a.pontoMinimo, b.pontoMinimo);
+    box.pontoMaximo = max(a.pontoMaximo, b.pontoMaximo);
+    return box;
+}
+
+
+float AABBTree::area(const BoundingBox& box) {
+    vec3 d = box.size();
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+
+bool AABBTree::contains(const BoundingBox& outer, const BoundingBox& inner) {
+    return all(lessThanEqual(outer.pontoMinimo, inner.pontoMinimo)) &&
+           all(greaterThanEqual(outer.pontoMaximo, inner.pontoMaximo));
+}
@@ -0,0 +1,92 @@
+#include "AssetLoader.h"
+#include "Profiler.h"
+#include <chrono>
+#include <iostream>
+
+
+AssetLoader::AssetLoader() : pending(0), stopping(false) {}
+
+
+AssetLoader::~AssetLoader() {
+    stop();
+}
+
+
+void AssetLoader::start(int count) {
+    stop();
+    stopping = false;
+    if (count < 1) { count = 1; }
+    for (int i = 0; i < count; i++) {
+        threads.push_back(thread(&AssetLoader::workerLoop, this));
+    }
+}
+
+
+void AssetLoader::stop() {
+    {
+        lock_guard<mutex> trava(lock);
+        stopping = true;
+        pending -= requests.size();
+        requests.clear();
+    }
+    wake.notify_all();
+
+    for (auto& t : threads) { t.join(); }
+    threads.clear();
+}
+
+
+void AssetLoader::request(const string& modelPath) {
+    {
+        lock_guard<mutex> trava(lock);
+        requests.push_back(modelPath);
+        pending++;
+    }
+    wake.notify_one();
+}
+
+
+bool AssetLoader::takeCompleted(Result& result) {
+    lock_guard<mutex> trava(lock);
+    if (completed.empty()) { return false; }
+    result = move(completed.front());
+    completed.pop_front();
+    pending--;
+    return true;
+}
+
+
+size_t AssetLoader::pendingCount() {
+    lock_guard<mutex> trava(lock);
+    return pending;
+}
+
+
+// Cada thread carrega um modelo por vez, sem segurar a trava durante o carregamento
+void AssetLoader::workerLoop() {
+    PROFILE_THREAD("carregamento");
+    while (true) {
+        string caminho;
+        {
+            unique_lock<mutex> trava(lock);
+            wake.wait(trava, [this]() { return stopping || !requests.empty(); });
+            if (stopping) { return; }
+            caminho = move(requests.front());
+            requests.pop_front();
+        }
+
+        PROFILE_ZONE_DETAIL("AssetLoader::load", caminho);
+        auto inicio = chrono::steady_clock::now();
+
+        shared_ptr<Mesh> mesh = make_shared<Mesh>();
+        if (!mesh->loadData(caminho)) {
+            cerr << "Falha ao carregar o modelo " << caminho << endl;
+            mesh.reset();   // sem buffers OpenGL: pode ser destruída fora da thread do contexto
+        }
+
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+
+        lock_guard<mutex> trava(lock);
+        completed.push_back(Result{ caminho, mesh, ms });
+    }
+}
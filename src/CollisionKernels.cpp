@@ -0,0 +1,357 @@
+#include "CollisionKernels.h"
+#include <cmath>
+#include <algorithm>
+
+// Os núcleos SSE/AVX são compilados com atributos de alvo por função (GCC/Clang/MinGW), sem exigir
+// -mavx no projeto inteiro; a escolha entre eles acontece em tempo de execução (ver initialize)
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define COLLISION_KERNELS_X86 1
+#include <immintrin.h>
+#define TARGET_SSE __attribute__((target("sse2")))
+#define TARGET_AVX __attribute__((target("avx")))
+#else
+#define COLLISION_KERNELS_X86 0
+#endif
+
+
+void RayPacket::add(const vec3& origin, const vec3& direction, float maxDistance) {
+    const float MIN_COMPONENT = 1e-30f;
+    originX[count] = origin.x;
+    originY[count] = origin.y;
+    originZ[count] = origin.z;
+    invDirX[count] = 1.0f / (direction.x != 0.0f ? direction.x : MIN_COMPONENT);
+    invDirY[count] = 1.0f / (direction.y != 0.0f ? direction.y : MIN_COMPONENT);
+    invDirZ[count] = 1.0f / (direction.z != 0.0f ? direction.z : MIN_COMPONENT);
+    tMax[count] = maxDistance;
+    count++;
+}
+
+
+void TriangleSoA::resize(size_t count) {
+    size_t padded = count + RayPacket::PACKET_SIZE;  // folga: a última carga de 8 pode passar do fim
+    for (vector<float>* component : { &v0x, &v0y, &v0z, &e1x, &e1y, &e1z, &e2x, &e2y, &e2z }) {
+        component->assign(padded, 0.0f);
+    }
+}
+
+
+void TriangleSoA::set(size_t index, const vec3& v0, const vec3& v1, const vec3& v2) {
+    vec3 e1 = v1 - v0;
+    vec3 e2 = v2 - v0;
+    v0x[index] = v0.x;  v0y[index] = v0.y;  v0z[index] = v0.z;
+    e1x[index] = e1.x;  e1y[index] = e1.y;  e1z[index] = e1.z;
+    e2x[index] = e2.x;  e2y[index] = e2.y;  e2z[index] = e2.z;
+}
+
+
+void TriangleSoA::clear() {
+    for (vector<float>* component : { &v0x, &v0y, &v0z, &e1x, &e1y, &e1z, &e2x, &e2y, &e2z }) {
+        vector<float>().swap(*component);
+    }
+}
+
+
+static const float TRIANGLE_EPSILON = 1e-8f;
+
+
+// ----------------------------------------------------------------------------------------------
+// Versões escalares (referência e fallback)
+
+static unsigned int raysVsBoxScalar(const RayPacket& rays, unsigned int active, const vec3& boxMin, const vec3& boxMax) {
+    unsigned int mask = 0;
+    for (int i = 0; i < rays.count; i++) {
+        if (!(active & (1u << i))) continue;
+
+        float t1x = (boxMin.x - rays.originX[i]) * rays.invDirX[i], t2x = (boxMax.x - rays.originX[i]) * rays.invDirX[i];
+        float t1y = (boxMin.y - rays.originY[i]) * rays.invDirY[i], t2y = (boxMax.y - rays.originY[i]) * rays.invDirY[i];
+        float t1z = (boxMin.z - rays.originZ[i]) * rays.invDirZ[i], t2z = (boxMax.z - rays.originZ[i]) * rays.invDirZ[i];
+
+        float tNear = std::max(std::max(std::min(t1x, t2x), std::min(t1y, t2y)), std::max(std::min(t1z, t2z), 0.0f));
+        float tFar  = std::min(std::min(std::max(t1x, t2x), std::max(t1y, t2y)), std::min(std::max(t1z, t2z), rays.tMax[i]));
+        if (tNear <= tFar) { mask |= 1u << i; }
+    }
+    return mask;
+}
+
+
+static long rayVsTrianglesScalar(const TriangleSoA& tris, size_t first, size_t count,
+                                 const vec3& origin, const vec3& direction,
+                                 float& tClosest, float& u, float& v) {
+    long closest = -1;
+    for (size_t i = first; i < first + count; i++) {
+        vec3 e1(tris.e1x[i], tris.e1y[i], tris.e1z[i]);
+        vec3 e2(tris.e2x[i], tris.e2y[i], tris.e2z[i]);
+        vec3 p = cross(direction, e2);
+        float det = dot(e1, p);
+        if (det > -TRIANGLE_EPSILON && det < TRIANGLE_EPSILON) continue;   // raio paralelo ao triângulo
+
+        float invDet = 1.0f / det;
+        vec3 s = origin - vec3(tris.v0x[i], tris.v0y[i], tris.v0z[i]);
+        float hitU = dot(s, p) * invDet;
+        if (hitU < 0.0f || hitU > 1.0f) continue;
+
+        vec3 q = cross(s, e1);
+        float hitV = dot(direction, q) * invDet;
+        if (hitV < 0.0f || hitU + hitV > 1.0f) continue;
+
+        float t = dot(e2, q) * invDet;
+        if (t > 0.0f && t <= tClosest) {
+            tClosest = t;
+            u = hitU;
+            v = hitV;
+            closest = (long)i;
+        }
+    }
+    return closest;
+}
+
+
+#if COLLISION_KERNELS_X86
+
+// ----------------------------------------------------------------------------------------------
+// SSE: 4 faixas
+
+TARGET_SSE
+static unsigned int raysVsBoxSSE(const RayPacket& rays, unsigned int active, const vec3& boxMin, const vec3& boxMax) {
+    const __m128 minX = _mm_set1_ps(boxMin.x), minY = _mm_set1_ps(boxMin.y), minZ = _mm_set1_ps(boxMin.z);
+    const __m128 maxX = _mm_set1_ps(boxMax.x), maxY = _mm_set1_ps(boxMax.y), maxZ = _mm_set1_ps(boxMax.z);
+    const __m128 zero = _mm_setzero_ps();
+
+    unsigned int mask = 0;
+    for (int base = 0; base < rays.count; base += 4) {
+        __m128 ox = _mm_load_ps(rays.originX + base), ix = _mm_load_ps(rays.invDirX + base);
+        __m128 oy = _mm_load_ps(rays.originY + base), iy = _mm_load_ps(rays.invDirY + base);
+        __m128 oz = _mm_load_ps(rays.originZ + base), iz = _mm_load_ps(rays.invDirZ + base);
+
+        __m128 t1x = _mm_mul_ps(_mm_sub_ps(minX, ox), ix), t2x = _mm_mul_ps(_mm_sub_ps(maxX, ox), ix);
+        __m128 t1y = _mm_mul_ps(_mm_sub_ps(minY, oy), iy), t2y = _mm_mul_ps(_mm_sub_ps(maxY, oy), iy);
+        __m128 t1z = _mm_mul_ps(_mm_sub_ps(minZ, oz), iz), t2z = _mm_mul_ps(_mm_sub_ps(maxZ, oz), iz);
+
+        __m128 tNear = _mm_max_ps(_mm_max_ps(_mm_min_ps(t1x, t2x), _mm_min_ps(t1y, t2y)),
+                                  _mm_max_ps(_mm_min_ps(t1z, t2z), zero));
+        __m128 tFar  = _mm_min_ps(_mm_min_ps(_mm_max_ps(t1x, t2x), _mm_max_ps(t1y, t2y)),
+                                  _mm_min_ps(_mm_max_ps(t1z, t2z), _mm_load_ps(rays.tMax + base)));
+
+        mask |= (unsigned int)_mm_movemask_ps(_mm_cmple_ps(tNear, tFar)) << base;
+    }
+    return mask & active;   // descarta faixas inativas ou além de count
+}
+
+
+TARGET_SSE
+static long rayVsTrianglesSSE(const TriangleSoA& tris, size_t first, size_t count,
+                              const vec3& origin, const vec3& direction,
+                              float& tClosest, float& u, float& v) {
+    const __m128 dx = _mm_set1_ps(direction.x), dy = _mm_set1_ps(direction.y), dz = _mm_set1_ps(direction.z);
+    const __m128 ox = _mm_set1_ps(origin.x), oy = _mm_set1_ps(origin.y), oz = _mm_set1_ps(origin.z);
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    const __m128 epsilon = _mm_set1_ps(TRIANGLE_EPSILON);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128i lanes = _mm_set_epi32(3, 2, 1, 0);
+
+    long closest = -1;
+    for (size_t base = first; base < first + count; base += 4) {
+        __m128 e1x = _mm_loadu_ps(&tris.e1x[base]), e1y = _mm_loadu_ps(&tris.e1y[base]), e1z = _mm_loadu_ps(&tris.e1z[base]);
+        __m128 e2x = _mm_loadu_ps(&tris.e2x[base]), e2y = _mm_loadu_ps(&tris.e2y[base]), e2z = _mm_loadu_ps(&tris.e2z[base]);
+
+        // p = direção x e2; det = e1 . p
+        __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+        __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+        __m128 invDet = _mm_div_ps(one, det);
+
+        // s = origem - v0; u = (s . p) / det
+        __m128 sx = _mm_sub_ps(ox, _mm_loadu_ps(&tris.v0x[base]));
+        __m128 sy = _mm_sub_ps(oy, _mm_loadu_ps(&tris.v0y[base]));
+        __m128 sz = _mm_sub_ps(oz, _mm_loadu_ps(&tris.v0z[base]));
+        __m128 hitU = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), invDet);
+
+        // q = s x e1; v = (direção . q) / det; t = (e2 . q) / det
+        __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+        __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+        __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+        __m128 hitV = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), invDet);
+        __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+
+        __m128 valid = _mm_cmpgt_ps(_mm_andnot_ps(signMask, det), epsilon);
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(hitU, zero));
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(hitV, zero));
+        valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_add_ps(hitU, hitV), one));
+        valid = _mm_and_ps(valid, _mm_cmpgt_ps(t, zero));
+        valid = _mm_and_ps(valid, _mm_cmple_ps(t, _mm_set1_ps(tClosest)));
+        __m128i remaining = _mm_set1_epi32((int)(first + count - base));
+        valid = _mm_and_ps(valid, _mm_castsi128_ps(_mm_cmplt_epi32(lanes, remaining)));
+
+        int bits = _mm_movemask_ps(valid);
+        if (bits == 0) continue;
+
+        alignas(16) float tLanes[4], uLanes[4], vLanes[4];
+        _mm_store_ps(tLanes, t);
+        _mm_store_ps(uLanes, hitU);
+        _mm_store_ps(vLanes, hitV);
+        for (int lane = 0; lane < 4; lane++) {
+            if ((bits & (1 << lane)) && tLanes[lane] <= tClosest) {
+                tClosest = tLanes[lane];
+                u = uLanes[lane];
+                v = vLanes[lane];
+                closest = (long)(base + lane);
+            }
+        }
+    }
+    return closest;
+}
+
+
+// ----------------------------------------------------------------------------------------------
+// AVX: 8 faixas
+
+TARGET_AVX
+static unsigned int raysVsBoxAVX(const RayPacket& rays, unsigned int active, const vec3& boxMin, const vec3& boxMax) {
+    __m256 ox = _mm256_load_ps(rays.originX), ix = _mm256_load_ps(rays.invDirX);
+    __m256 oy = _mm256_load_ps(rays.originY), iy = _mm256_load_ps(rays.invDirY);
+    __m256 oz = _mm256_load_ps(rays.originZ), iz = _mm256_load_ps(rays.invDirZ);
+
+    __m256 t1x = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(boxMin.x), ox), ix);
+    __m256 t2x = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(boxMax.x), ox), ix);
+    __m256 t1y = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(boxMin.y), oy), iy);
+    __m256 t2y = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(boxMax.y), oy), iy);
+    __m256 t1z = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(boxMin.z), oz), iz);
+    __m256 t2z = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(boxMax.z), oz), iz);
+
+    __m256 tNear = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(t1x, t2x), _mm256_min_ps(t1y, t2y)),
+                                 _mm256_max_ps(_mm256_min_ps(t1z, t2z), _mm256_setzero_ps()));
+    __m256 tFar  = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(t1x, t2x), _mm256_max_ps(t1y, t2y)),
+                                 _mm256_min_ps(_mm256_max_ps(t1z, t2z), _mm256_load_ps(rays.tMax)));
+
+    unsigned int mask = (unsigned int)_mm256_movemask_ps(_mm256_cmp_ps(tNear, tFar, _CMP_LE_OQ));
+    return mask & active;
+}
+
+
+TARGET_AVX
+static long rayVsTrianglesAVX(const TriangleSoA& tris, size_t first, size_t count,
+                              const vec3& origin, const vec3& direction,
+                              float& tClosest, float& u, float& v) {
+    const __m256 dx = _mm256_set1_ps(direction.x), dy = _mm256_set1_ps(direction.y), dz = _mm256_set1_ps(direction.z);
+    const __m256 ox = _mm256_set1_ps(origin.x), oy = _mm256_set1_ps(origin.y), oz = _mm256_set1_ps(origin.z);
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+    const __m256 epsilon = _mm256_set1_ps(TRIANGLE_EPSILON);
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 lanes = _mm256_set_ps(7, 6, 5, 4, 3, 2, 1, 0);
+
+    long closest = -1;
+    for (size_t base = first; base < first + count; base += 8) {
+        __m256 e1x = _mm256_loadu_ps(&tris.e1x[base]), e1y = _mm256_loadu_ps(&tris.e1y[base]), e1z = _mm256_loadu_ps(&tris.e1z[base]);
+        __m256 e2x = _mm256_loadu_ps(&tris.e2x[base]), e2y = _mm256_loadu_ps(&tris.e2y[base]), e2z = _mm256_loadu_ps(&tris.e2z[base]);
+
+        __m256 px = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+        __m256 py = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+        __m256 pz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+        __m256 det = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, px), _mm256_mul_ps(e1y, py)), _mm256_mul_ps(e1z, pz));
+        __m256 invDet = _mm256_div_ps(one, det);
+
+        __m256 sx = _mm256_sub_ps(ox, _mm256_loadu_ps(&tris.v0x[base]));
+        __m256 sy = _mm256_sub_ps(oy, _mm256_loadu_ps(&tris.v0y[base]));
+        __m256 sz = _mm256_sub_ps(oz, _mm256_loadu_ps(&tris.v0z[base]));
+        __m256 hitU = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, px), _mm256_mul_ps(sy, py)), _mm256_mul_ps(sz, pz)), invDet);
+
+        __m256 qx = _mm256_sub_ps(_mm256_mul_ps(sy, e1z), _mm256_mul_ps(sz, e1y));
+        __m256 qy = _mm256_sub_ps(_mm256_mul_ps(sz, e1x), _mm256_mul_ps(sx, e1z));
+        __m256 qz = _mm256_sub_ps(_mm256_mul_ps(sx, e1y), _mm256_mul_ps(sy, e1x));
+        __m256 hitV = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)), _mm256_mul_ps(dz, qz)), invDet);
+        __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)), _mm256_mul_ps(e2z, qz)), invDet);
+
+        __m256 valid = _mm256_cmp_ps(_mm256_andnot_ps(signMask, det), epsilon, _CMP_GT_OQ);
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(hitU, zero, _CMP_GE_OQ));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(hitV, zero, _CMP_GE_OQ));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(_mm256_add_ps(hitU, hitV), one, _CMP_LE_OQ));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(t, zero, _CMP_GT_OQ));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(t, _mm256_set1_ps(tClosest), _CMP_LE_OQ));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(lanes, _mm256_set1_ps((float)(first + count - base)), _CMP_LT_OQ));
+
+        int bits = _mm256_movemask_ps(valid);
+        if (bits == 0) continue;
+
+        alignas(32) float tLanes[8], uLanes[8], vLanes[8];
+        _mm256_store_ps(tLanes, t);
+        _mm256_store_ps(uLanes, hitU);
+        _mm256_store_ps(vLanes, hitV);
+        for (int lane = 0; lane < 8; lane++) {
+            if ((bits & (1 << lane)) && tLanes[lane] <= tClosest) {
+                tClosest = tLanes[lane];
+                u = uLanes[lane];
+                v = vLanes[lane];
+                closest = (long)(base + lane);
+            }
+        }
+    }
+    return closest;
+}
+
+#endif
+
+
+// ----------------------------------------------------------------------------------------------
+// Seleção em tempo de execução
+
+CollisionKernels::Level CollisionKernels::supportedLevel() {
+#if COLLISION_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx")) return AVX;
+    if (__builtin_cpu_supports("sse2")) return SSE;
+#endif
+    return SCALAR;
+}
+
+
+const CollisionKernels::Kernels* CollisionKernels::kernelsFor(Level value) {
+    static const Kernels escalar = { SCALAR, raysVsBoxScalar, rayVsTrianglesScalar };
+#if COLLISION_KERNELS_X86
+    static const Kernels sse = { SSE, raysVsBoxSSE, rayVsTrianglesSSE };
+    static const Kernels avx = { AVX, raysVsBoxAVX, rayVsTrianglesAVX };
+
+    switch (std::min(value, supportedLevel())) {
+        case AVX: return &avx;
+        case SSE: return &sse;
+        default:  break;
+    }
+#endif
+    return &escalar;
+}
+
+
+// Detecção feita na inicialização estática, antes de main: nenhuma thread de colisão existe ainda, e as
+// chamadas seguintes só leem o ponteiro (sem a inicialização preguiçosa, que era uma disputa entre threads)
+atomic<const CollisionKernels::Kernels*> CollisionKernels::current(CollisionKernels::kernelsFor(CollisionKernels::AVX));
+
+
+CollisionKernels::Level CollisionKernels::level() {
+    return current.load(memory_order_acquire)->level;
+}
+
+
+void CollisionKernels::setLevel(Level requested) {
+    current.store(kernelsFor(requested), memory_order_release);
+}
+
+
+const char* CollisionKernels::levelName(Level value) {
+    switch (value) {
+        case AVX: return "AVX";
+        case SSE: return "SSE";
+        default:  return "escalar";
+    }
+}
+
+
+unsigned int CollisionKernels::raysVsBox(const RayPacket& rays, unsigned int active, const vec3& boxMin, const vec3& boxMax) {
+    return current.load(memory_order_acquire)->raysVsBox(rays, active & ((1u << rays.count) - 1), boxMin, boxMax);
+}
+
+
+long CollisionKernels::rayVsTriangles(const TriangleSoA& tris, size_t first, size_t count,
+                                      const vec3& origin, const vec3& direction,
+                                      float& tClosest, float& u, float& v) {
+    return current.load(memory_order_acquire)->rayVsTriangles(tris, first, count, origin, direction, tClosest, u, v);
+}
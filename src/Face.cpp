@@ -15,33 +15,37 @@ Face::Face(const vector<unsigned int>& vIndices,
 vector<Face> Face::triangulate() const {
 
     vector<Face> faces_triangulares = {};   // Vetor para armazenar as faces triangulares
-    
+    triangulate(faces_triangulares);
+    return faces_triangulares;
+}
+
+
+// Acrescenta ao vetor "triangles" os triângulos gerados por "fan triangulation"
+void Face::triangulate(vector<Face>& triangles) const {
+
     // se a face tem menos de 3 vértices, não é possível formar um triângulo
-    if (vertexIndices.size()  < 3) { return faces_triangulares; }
+    if (vertexIndices.size()  < 3) { return; }
 
-    // Se a face já é um triângulo, retorna ela mesma
+    // Se a face já é um triângulo, adiciona ela mesma
     if (vertexIndices.size() == 3) {
-        faces_triangulares.push_back(*this);
-        return faces_triangulares;
+        triangles.push_back(*this);
+        return;
     }
     
     // Triangulação usando fan triangulation
-    vector<unsigned int> triangleVertices, triangleTextures, triangleNormals;
-
     for (size_t i = 1; i < vertexIndices.size() - 1; i++) {
 
-        triangleVertices = {vertexIndices[0], vertexIndices[i], vertexIndices[i + 1]};  // o primeiro vértice (fixo = 0) + os dois próximos
+        triangles.emplace_back();
+        Face& triangulo = triangles.back();
+
+        triangulo.vertexIndices = {vertexIndices[0], vertexIndices[i], vertexIndices[i + 1]};  // o primeiro vértice (fixo = 0) + os dois próximos
 
         if (!textureIndices.empty()) {
-            triangleTextures = {textureIndices[0], textureIndices[i], textureIndices[i + 1]};
+            triangulo.textureIndices = {textureIndices[0], textureIndices[i], textureIndices[i + 1]};
         }
         
         if (!normalIndices.empty()) {
-            triangleNormals = {normalIndices[0], normalIndices[i], normalIndices[i + 1]};
+            triangulo.normalIndices = {normalIndices[0], normalIndices[i], normalIndices[i + 1]};
         }
-
-        faces_triangulares.emplace_back(triangleVertices, triangleTextures, triangleNormals);
     }
-
-    return faces_triangulares;
 }
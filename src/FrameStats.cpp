@@ -0,0 +1,63 @@
+#include "FrameStats.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+FrameStats::Summary FrameStats::summary() const {
+    Summary resumo = { samples.size(), 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    if (samples.empty()) return resumo;
+
+    double soma = 0.0;
+    for (double ms : samples) { soma += ms; }
+
+    resumo.minMs = *min_element(samples.begin(), samples.end());
+    resumo.maxMs = *max_element(samples.begin(), samples.end());
+    resumo.avgMs = soma / samples.size();
+    resumo.p50Ms = percentile(50.0);
+    resumo.p95Ms = percentile(95.0);
+    resumo.p99Ms = percentile(99.0);
+    return resumo;
+}
+
+
+double FrameStats::percentile(double p) const {
+    if (samples.empty()) return 0.0;
+
+    vector<double> ordenadas = samples;
+    size_t posto = (size_t)ceil(p / 100.0 * ordenadas.size());
+    posto = std::min(std::max(posto, (size_t)1), ordenadas.size());
+    nth_element(ordenadas.begin(), ordenadas.begin() + (posto - 1), ordenadas.end());
+    return ordenadas[posto - 1];
+}
+
+
+void FrameStats::print(const string& label) const {
+    Summary resumo = summary();
+    cout << label << ": " << resumo.frames << " quadros - min " << resumo.minMs << " ms, media " << resumo.avgMs
+         << " ms, p50 " << resumo.p50Ms << " ms, p95 " << resumo.p95Ms << " ms, p99 " << resumo.p99Ms
+         << " ms, max " << resumo.maxMs << " ms" << endl;
+}
+
+
+string FrameStats::toJSON() const {
+    Summary resumo = summary();
+    ostringstream json;
+    json << "{\"min\": " << resumo.minMs << ", \"avg\": " << resumo.avgMs << ", \"p50\": " << resumo.p50Ms
+         << ", \"p95\": " << resumo.p95Ms << ", \"p99\": " << resumo.p99Ms << ", \"max\": " << resumo.maxMs << "}";
+    return json.str();
+}
+
+
+bool FrameStats::writeCSV(const string& path) const {
+    ofstream arquivo(path);
+    if (!arquivo.is_open()) {
+        cerr << "Falha ao criar arquivo de estatisticas: " << path << endl;
+        return false;
+    }
+
+    arquivo << "quadro,ms" << endl;
+    for (size_t i = 0; i < samples.size(); i++) { arquivo << i << "," << samples[i] << endl; }
+    return true;
+}
@@ -0,0 +1,105 @@
+#include "ImageWriter.h"
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cstdint>
+
+// CRC-32 dos chunks do PNG (polinômio 0xEDB88320), com tabela calculada no primeiro uso
+static uint32_t crc32(const unsigned char* data, size_t size, uint32_t crc = 0) {
+    static uint32_t tabela[256];
+    static bool pronta = false;
+    if (!pronta) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) { c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1; }
+            tabela[n] = c;
+        }
+        pronta = true;
+    }
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) { crc = tabela[(crc ^ data[i]) & 0xFF] ^ (crc >> 8); }
+    return ~crc;
+}
+
+
+static void appendBigEndian(vector<unsigned char>& out, uint32_t value) {
+    out.push_back((unsigned char)(value >> 24));
+    out.push_back((unsigned char)(value >> 16));
+    out.push_back((unsigned char)(value >> 8));
+    out.push_back((unsigned char)value);
+}
+
+
+// Chunk = tamanho, tipo, dados e CRC de tipo + dados
+static void writeChunk(ofstream& file, const char type[4], const vector<unsigned char>& data) {
+    vector<unsigned char> chunk;
+    appendBigEndian(chunk, (uint32_t)data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    appendBigEndian(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+    file.write((const char*)chunk.data(), chunk.size());
+}
+
+
+bool ImageWriter::writePNG(const string& path, int width, int height, int channels,
+                           const unsigned char* pixels, bool flipVertical) {
+    if (width <= 0 || height <= 0 || (channels != 3 && channels != 4)) return false;
+
+    ofstream file(path, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Falha ao criar imagem: " << path << endl;
+        return false;
+    }
+
+    // Dados da imagem: cada linha precedida pelo filtro 0 (nenhum)
+    size_t bytesLinha = (size_t)width * channels;
+    vector<unsigned char> linhas;
+    linhas.reserve((bytesLinha + 1) * height);
+    for (int y = 0; y < height; y++) {
+        const unsigned char* linha = pixels + (size_t)(flipVertical ? height - 1 - y : y) * bytesLinha;
+        linhas.push_back(0);
+        linhas.insert(linhas.end(), linha, linha + bytesLinha);
+    }
+
+    // Fluxo zlib: cabeçalho, blocos "stored" de até 65535 bytes e Adler-32 dos dados
+    vector<unsigned char> zlib;
+    zlib.reserve(linhas.size() + linhas.size() / 65535 * 5 + 16);
+    zlib.push_back(0x78);
+    zlib.push_back(0x01);
+    for (size_t inicio = 0; ; inicio += 65535) {
+        size_t tamanho = linhas.size() - inicio < 65535 ? linhas.size() - inicio : 65535;
+        bool ultimo = inicio + tamanho >= linhas.size();
+        zlib.push_back(ultimo ? 1 : 0);
+        zlib.push_back((unsigned char)(tamanho & 0xFF));
+        zlib.push_back((unsigned char)(tamanho >> 8));
+        zlib.push_back((unsigned char)(~tamanho & 0xFF));
+        zlib.push_back((unsigned char)((~tamanho >> 8) & 0xFF));
+        zlib.insert(zlib.end(), linhas.begin() + inicio, linhas.begin() + inicio + tamanho);
+        if (ultimo) break;
+    }
+
+    uint32_t a = 1, b = 0;
+    for (unsigned char byte : linhas) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendBigEndian(zlib, (b << 16) | a);
+
+    vector<unsigned char> cabecalho;
+    appendBigEndian(cabecalho, (uint32_t)width);
+    appendBigEndian(cabecalho, (uint32_t)height);
+    cabecalho.push_back(8);                         // bits por canal
+    cabecalho.push_back(channels == 4 ? 6 : 2);     // RGBA ou RGB
+    cabecalho.push_back(0);                         // compressão deflate
+    cabecalho.push_back(0);                         // filtros por linha
+    cabecalho.push_back(0);                         // sem entrelaçamento
+
+    static const unsigned char assinatura[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.write((const char*)assinatura, sizeof(assinatura));
+    writeChunk(file, "IHDR", cabecalho);
+    writeChunk(file, "IDAT", zlib);
+    writeChunk(file, "IEND", vector<unsigned char>());
+
+    return file.good();
+}
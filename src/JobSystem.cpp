@@ -0,0 +1,192 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <chrono>
+
+// Conjunto a que a thread atual pertence (nullptr fora de qualquer conjunto) e a sua fila nele
+static thread_local const JobSystem* currentPool = nullptr;
+static thread_local unsigned int currentIndex = 0;
+
+// Fila de entrada de cada thread de fora dos conjuntos (renderização, simulação, ...), na ordem do primeiro uso
+static atomic<unsigned int> nextEntry(0);
+static thread_local unsigned int entryIndex = nextEntry.fetch_add(1);
+
+
+JobSystem::JobSystem(int workers) : queued(0), stopping(false) {
+    start(workers);
+}
+
+
+JobSystem::~JobSystem() {
+    stop();
+}
+
+
+void JobSystem::resize(int workers) {
+    stop();
+    start(workers);
+}
+
+
+void JobSystem::start(int workers) {
+    if (workers < 0) {
+        unsigned int nucleos = thread::hardware_concurrency();
+        workers = nucleos > 1 ? (int)nucleos - 1 : 0;
+    }
+
+    stopping.store(false);
+    queues.clear();
+    for (unsigned int i = 0; i < (unsigned int)workers + ENTRY_QUEUES; i++) { queues.push_back(unique_ptr<Queue>(new Queue())); }
+
+    for (int i = 0; i < workers; i++) {
+        threads.push_back(thread(&JobSystem::workerLoop, this, (unsigned int)i));
+    }
+}
+
+
+void JobSystem::stop() {
+    {
+        lock_guard<mutex> trava(sleepLock);
+        stopping.store(true);
+    }
+    wake.notify_all();
+
+    for (auto& t : threads) { t.join(); }
+    threads.clear();
+}
+
+
+unsigned int JobSystem::homeQueue() const {
+    return currentPool == this ? currentIndex : (unsigned int)threads.size() + entryIndex % ENTRY_QUEUES;
+}
+
+
+void JobSystem::run(Counter& counter, Job job) {
+    counter.pending.fetch_add(1);
+
+    Queue& fila = *queues[homeQueue()];
+    {
+        lock_guard<mutex> trava(fila.lock);
+        fila.tasks.push_back(Task{ move(job), &counter });
+    }
+    queued.fetch_add(1);
+
+    // sem threads no conjunto o job é executado por quem chamar wait
+    if (!threads.empty()) {
+        { lock_guard<mutex> trava(sleepLock); }
+        wake.notify_one();
+    }
+}
+
+
+void JobSystem::wait(Counter& counter) {
+    unsigned int home = homeQueue();
+    bool doConjunto = currentPool == this;
+    while (counter.pending.load() > 0) {
+        if (!tryExecute(home, doConjunto)) { this_thread::yield(); }  // os jobs restantes já estão em execução
+    }
+}
+
+
+void JobSystem::workerLoop(unsigned int index) {
+    currentPool = this;
+    currentIndex = index;
+    PROFILE_THREAD("trabalho " + to_string(index));
+
+    while (true) {
+        if (tryExecute(index, true)) continue;
+
+        unique_lock<mutex> trava(sleepLock);
+        wake.wait(trava, [this]() { return queued.load() > 0 || stopping.load(); });
+        if (stopping.load() && queued.load() == 0) return;
+    }
+}
+
+
+// Primeiro a própria fila (pelo fim), depois as outras a partir da seguinte (pelo início)
+// Threads de fora (stealOthers = false) ficam só na própria fila: os jobs das outras podem ser fases
+// longas de outra thread (uma tarefa da simulação executada durante a espera da renderização atrasa o quadro)
+bool JobSystem::tryExecute(unsigned int home, bool stealOthers) {
+    if (queued.load() == 0) return false;
+
+    Task tarefa;
+    bool encontrada = pop(home, tarefa);
+    for (unsigned int i = 1; stealOthers && !encontrada && i < queues.size(); i++) {
+        encontrada = steal((home + i) % queues.size(), tarefa);
+    }
+    if (!encontrada) return false;
+
+    execute(tarefa);
+    return true;
+}
+
+
+bool JobSystem::pop(unsigned int queue, Task& task) {
+    Queue& fila = *queues[queue];
+    lock_guard<mutex> trava(fila.lock);
+    if (fila.tasks.empty()) return false;
+    task = move(fila.tasks.back());
+    fila.tasks.pop_back();
+    queued.fetch_sub(1);
+    return true;
+}
+
+
+bool JobSystem::steal(unsigned int queue, Task& task) {
+    Queue& fila = *queues[queue];
+    lock_guard<mutex> trava(fila.lock);
+    if (fila.tasks.empty()) return false;
+    task = move(fila.tasks.front());
+    fila.tasks.pop_front();
+    queued.fetch_sub(1);
+    return true;
+}
+
+
+void JobSystem::execute(Task& task) {
+    task.job();
+    task.counter->pending.fetch_sub(1);     // depois do job: quem espera pode liberar o que ele usou
+}
+
+
+int TaskGraph::add(const char* name, JobSystem::Job job, initializer_list<int> dependencies) {
+    int indice = (int)nodes.size();
+
+    unique_ptr<Node> node(new Node());
+    node->name = name;
+    node->job = move(job);
+    node->dependencyCount = (int)dependencies.size();
+    node->remaining.store(0);
+    node->micros = 0.0;
+    nodes.push_back(move(node));
+
+    for (int dependencia : dependencies) { nodes[dependencia]->dependents.push_back(indice); }
+    return indice;
+}
+
+
+void TaskGraph::execute(JobSystem& jobs) {
+    for (auto& node : nodes) { node->remaining.store(node->dependencyCount); }
+
+    JobSystem::Counter counter;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (nodes[i]->dependencyCount == 0) { launch(jobs, counter, (int)i); }
+    }
+    jobs.wait(counter);
+}
+
+
+// Enfileira a tarefa; ao terminar, ela enfileira as dependentes cuja última dependência era ela
+// (antes de sair do lote, de forma que o contador nunca chega a zero com tarefas por enfileirar)
+void TaskGraph::launch(JobSystem& jobs, JobSystem::Counter& counter, int task) {
+    jobs.run(counter, [this, &jobs, &counter, task]() {
+        Node& node = *nodes[task];
+
+        auto inicio = chrono::steady_clock::now();
+        node.job();
+        node.micros = chrono::duration<double, micro>(chrono::steady_clock::now() - inicio).count();
+
+        for (int dependente : node.dependents) {
+            if (nodes[dependente]->remaining.fetch_sub(1) == 1) { launch(jobs, counter, dependente); }
+        }
+    });
+}
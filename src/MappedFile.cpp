@@ -0,0 +1,108 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+    #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+
+#ifdef _WIN32
+MappedFile::MappedFile()
+    : fileData(nullptr), fileSize(0), opened(false), fileHandle(nullptr), mappingHandle(nullptr) {}
+#else
+MappedFile::MappedFile()
+    : fileData(nullptr), fileSize(0), opened(false), fileDescriptor(-1) {}
+#endif
+
+
+MappedFile::~MappedFile() { close(); }
+
+
+// Mapeia o arquivo inteiro em memória (somente leitura)
+// Arquivos vazios são considerados abertos, com data() == nullptr e size() == 0
+bool MappedFile::open(const string& path) {
+
+    close();    // desfaz um mapeamento anterior, se houver
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) { return false; }
+
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(file, &length)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    fileSize = (size_t)length.QuadPart;
+    opened = true;
+
+    if (fileSize == 0) { return true; }  // CreateFileMapping não aceita arquivos vazios
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+        close();
+        return false;
+    }
+    mappingHandle = mapping;
+
+    fileData = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (fileData == nullptr) {
+        close();
+        return false;
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { return false; }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    fileDescriptor = fd;
+    fileSize = (size_t)info.st_size;
+    opened = true;
+
+    if (fileSize == 0) { return true; }  // mmap não aceita tamanho zero
+
+    void* address = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED) {
+        close();
+        return false;
+    }
+    madvise(address, fileSize, MADV_SEQUENTIAL);   // o parser lê o arquivo do início ao fim
+    fileData = (const char*)address;
+#endif
+
+    return true;
+}
+
+
+// Desfaz o mapeamento e fecha o arquivo
+void MappedFile::close() {
+#ifdef _WIN32
+    if (fileData)      { UnmapViewOfFile(fileData); }
+    if (mappingHandle) { CloseHandle((HANDLE)mappingHandle); }
+    if (fileHandle)    { CloseHandle((HANDLE)fileHandle); }
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    if (fileData) { munmap((void*)fileData, fileSize); }
+    if (fileDescriptor >= 0) { ::close(fileDescriptor); }
+    fileDescriptor = -1;
+#endif
+    fileData = nullptr;
+    fileSize = 0;
+    opened = false;
+}
@@ -1,12 +1,18 @@
 #include "Mesh.h"
 #include "OBJReader.h"
+#include "MeshCache.h"
 #include "Shader.h"
+#include "RenderQueue.h"
+#include "RenderStats.h"
+#include "Profiler.h"
+#include <glad/glad.h>
 #include <iostream>
 #include <algorithm>
 #include <cfloat>
+#include <cstring>
 
 
-Mesh::Mesh() {}
+Mesh::Mesh() : VAO(0), VBO(0), EBO(0), indexType(GL_UNSIGNED_INT), instanceVBO(0), instanceCapacity(0) {}
 
 
 Mesh::~Mesh() { cleanup(); }
@@ -16,6 +22,13 @@ Mesh::~Mesh() { cleanup(); }
 // lembrando a sequência de chamadas:
 // System::loadSceneObjects -> Object3D::loadObject -> Mesh::readObjectModel -> OBJReader::readFileOBJ
 bool Mesh::readObjectModel(string& objFilePath) {
+    if (!loadData(objFilePath)) { return false; }
+    upload();
+    return true;
+}
+
+
+bool Mesh::loadData(const string& objFilePath) {
     
     // "OBJReader::readFileOBJ" preenche os vetores e mapas da malha (Mesh), passados por referência:
     // vertices  - vetor com os vértices do modelo, no formato VEC3, definido aqui na classe Mesh
@@ -26,40 +39,268 @@ bool Mesh::readObjectModel(string& objFilePath) {
 
     // objFilePath - caminho do arquivo do modelo (OBJ), recebido como parâmetro
 
-    bool leuArquivoOBJ = OBJReader::readFileOBJ(objFilePath, vertices, texCoords, normals, groups, materials);
-
-    if (!leuArquivoOBJ) { return false; } // se não leu o arquivo OBJ, retorna falso
-
     // Extrai o diretório do modelo para carregar texturas
     size_t pos = objFilePath.find_last_of("/\\\\");
-    string modelDirectory = (pos != string::npos) ? objFilePath.substr(0, pos) : ".";
+    modelDirectory = (pos != string::npos) ? objFilePath.substr(0, pos) : ".";
 
-    // Carrega as texturas e configura os buffers OpenGL para cada grupo
-    for (auto& group : groups) {
-        group.loadMaterialTexture(modelDirectory);  // Carrega as texturas dos materiais MTL para cada grupo
-        group.setupBuffers(vertices, texCoords, normals); // Configura os buffers OpenGL (VBOs, VAOs) para cada grupo da malha
+    // Se houver um cache binário atualizado do modelo (ver MeshCache), os grupos, materiais,
+    // bounding box, vértices e índices vêm dele e a leitura do OBJ/MTL em texto é dispensada
+    if (!MeshCache::load(objFilePath, *this)) {
+
+        bool leuArquivoOBJ = OBJReader::readFileOBJ(objFilePath, vertices, texCoords, normals, groups, materials,
+                                                     0, &materialFiles);
+
+        if (!leuArquivoOBJ) { return false; } // se não leu o arquivo OBJ, retorna falso
+
+        // Monta os vértices e índices de cada grupo
+        for (auto& group : groups) {
+            group.buildVertexData(vertices, texCoords, normals); // Monta os vértices únicos e índices de cada grupo da malha
+        }
+
+        setupBuffers(); // Junta os vértices e índices de todos os grupos nos dados dos buffers únicos da malha
+
+        calculateBoundingBox(); // Calcula a bounding box do objeto
+
+        MeshCache::save(objFilePath, *this); // Grava o cache binário para as próximas execuções
     }
 
-    calculateBoundingBox(); // Calcula a bounding box do objeto
+    buildBVH(); // Monta a hierarquia de triângulos usada nas colisões
+
+    // Decodifica as texturas dos materiais MTL de cada grupo (uma vez por arquivo)
+    for (const auto& group : groups) {
+        if (!group.material.hasTexture()) { continue; }
+        string texturePath = modelDirectory + "/" + group.material.map_Kd;
+        if (stagedTextures.count(texturePath)) { continue; }
+        Texture::decode(texturePath, stagedTextures[texturePath]);
+    }
 
     return true;
 }
 
 
-// Renderiza a malha chamando render() de cada grupo
-void Mesh::render(const Shader& shader) const {
+// Envia a malha carregada por loadData à OpenGL
+// As texturas vêm primeiro: os lotes de desenho só juntam grupos com o mesmo textureID
+void Mesh::upload() {
+    for (auto& group : groups) {
+        if (!group.material.hasTexture()) { continue; }
+        string texturePath = modelDirectory + "/" + group.material.map_Kd;
+        group.textureID = Texture::upload(texturePath, stagedTextures[texturePath]);
+
+        if (group.textureID != 0) {
+            cout << "Textura vinculada ao grupo \"" << group.name << "\" (ID: " << group.textureID << ")" << endl;
+        } else {
+            cerr << "Falha ao carregar textura do arquivo MTL para o grupo \"" << group.name << "\": " << texturePath << endl;
+        }
+    }
+    stagedTextures.clear();
+
+    uploadBuffers(vertexData.data(), vertexData.size(), indexData.data(), indexData.size());
+    buildDrawBatches();
+}
+
+
+size_t Mesh::uploadBytes() const {
+    size_t bytes = vertexData.size() * sizeof(float) + indexData.size() * sizeof(unsigned int);
+    for (const auto& textura : stagedTextures) { bytes += textura.second.bytes(); }
+    return bytes;
+}
+
+
+// Junta os vértices e índices de todos os grupos nos buffers únicos da malha
+void Mesh::setupBuffers() {
+    PROFILE_ZONE("Mesh::setupBuffers");
+
+    // Ordena os grupos por textura e material (ordenação estável: grupos do mesmo material mantêm
+    // a ordem do OBJ) para que grupos de mesmo material fiquem vizinhos no EBO e formem um só lote
+    stable_sort(groups.begin(), groups.end(), [](const Group& a, const Group& b) {
+        if (a.material.map_Kd != b.material.map_Kd) { return a.material.map_Kd < b.material.map_Kd; }
+        return a.material.name < b.material.name;
+    });
+
+    size_t totalFloats = 0, totalIndices = 0;
     for (const auto& group : groups) {
-        group.render(shader);
+        totalFloats  += group.vertices.size();
+        totalIndices += group.indices.size();
+    }
+
+    vertexData.clear();
+    indexData.clear();
+    vertexData.reserve(totalFloats);
+    indexData.reserve(totalIndices);
+
+    for (auto& group : groups) {
+        group.baseVertex  = vertexData.size() / 8;  // 8 floats por vértice
+        group.firstIndex  = indexData.size();
+        group.vertexCount = group.vertices.size() / 8;
+        group.indexCount  = group.indices.size();
+
+        vertexData.insert(vertexData.end(), group.vertices.begin(), group.vertices.end());
+        for (unsigned int index : group.indices) {
+            indexData.push_back(index + group.baseVertex);  // índice local do grupo -> índice no VBO da malha
+        }
+
+        group.cleanup();    // os dados do grupo agora estão em vertexData/indexData
+    }
+}
+
+
+// Cria VAO, VBO e EBO da malha
+void Mesh::uploadBuffers(const float* vertexFloats, size_t floatCount,
+                         const unsigned int* indexValues, size_t indexCount) {
+    PROFILE_ZONE("Mesh::uploadBuffers");
+
+    // "vertexFloats" é o vetor de dados (floats) dos vértices de todos os grupos (posições, normais,
+    // coordenadas de textura) para envio à OpenGL. Armazena sequencialmente os atributos de cada vértice.
+    // Exemplo: v1.x, v1.y, v1.z, v1.u, v1.v, v1.nx, v1.ny, v1.nz, v2.x, v2.y, ...
+    // Cada grupo de 8 floats representa um vértice (posição<3> + texCoord<2> + normal<3>)
+    size_t totalVertices = floatCount / 8;
+
+    // Configuração do VAO (Vertex Array Object) da malha
+    // O VAO é vinculado primeiro porque ele guarda o vínculo do EBO (GL_ELEMENT_ARRAY_BUFFER)
+    glGenVertexArrays(1, &VAO); // Geração do identificador do VAO
+    glBindVertexArray(VAO); // Vincula (bind) o VAO da malha
+
+    // Configuração do VBO (Vertex Buffer Object) da malha
+    glGenBuffers(1, &VBO); // Geração do identificador do VBO
+    glBindBuffer(GL_ARRAY_BUFFER, VBO); // Vincula (bind) o VBO da malha
+    glBufferData(GL_ARRAY_BUFFER, floatCount * sizeof(float), vertexFloats, GL_STATIC_DRAW); // Envia os dados dos vértices para o buffer OpenGL
+
+    // Configuração do EBO (Element Buffer Object) da malha
+    // Com até 65535 vértices na malha os índices cabem em 16 bits (metade da memória e da banda de envio)
+    glGenBuffers(1, &EBO); // Geração do identificador do EBO
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO); // Vincula (bind) o EBO ao VAO da malha
+    if (totalVertices <= 0xFFFF) {
+        vector<unsigned short> indices16(indexValues, indexValues + indexCount);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned short), indices16.data(), GL_STATIC_DRAW);
+        indexType = GL_UNSIGNED_SHORT;
+    } else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), indexValues, GL_STATIC_DRAW);
+        indexType = GL_UNSIGNED_INT;
     }
+
+    // Atributos de vértices (vertex attributes) para que a GPU interprete corretamente os dados do VBO
+
+    // Configura Atributo coordenada de posição - coord x, y, z - 3 valores
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0); // location 0, offset 0, posição do vértice
+    glEnableVertexAttribArray(0);   // Habilita o "location 0" do VAO - no vertex shader teremos layout(location = 0) para posição
+    
+    // Configura Atributo coordenada de textura - coord s, t - 2 valores
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float))); // location 1, offset 3 floats, texCoord do vértice
+    glEnableVertexAttribArray(1);   // Habilita o "location 1" do VAO - no vertex shader teremos layout(location = 1) para texCoord
+    
+    // Configura Atributo normal - coord x, y, z - 3 valores
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(5 * sizeof(float))); // location 2, offset 5 floats, normal do vértice
+    glEnableVertexAttribArray(2);   // Habilita o "location 2" do VAO - no vertex shader teremos layout(location = 2) para normal   
+
+    // Configura Atributo matriz de modelo por instância - mat4 ocupa 4 locations (3 a 6), uma coluna em cada
+    // O buffer começa vazio e é preenchido a cada quadro com as transformações dos objetos (Mesh::submit)
+    glGenBuffers(1, &instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    for (unsigned int coluna = 0; coluna < 4; coluna++) {
+        glVertexAttribPointer(3 + coluna, 4, GL_FLOAT, GL_FALSE, sizeof(mat4), (void*)(coluna * sizeof(vec4)));
+        glEnableVertexAttribArray(3 + coluna);
+        glVertexAttribDivisor(3 + coluna, 1);   // avança uma vez por instância, não por vértice
+    }
+    
+    // Desvincula o VAO e o VBO da malha (boa prática)
+    // O EBO só é desvinculado depois do VAO, senão o VAO perderia a referência ao buffer de índices
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    cout << "Malha configurada com VBO = " << VBO << ", EBO = " << EBO << " e VAO = " << VAO << " ("
+         << totalVertices << " vertices, " << indexCount << " indices, " << groups.size() << " grupos)" << endl;
+}
+
+
+// Monta os lotes de desenho: grupos vizinhos no EBO com o mesmo material viram uma única chamada
+void Mesh::buildDrawBatches() {
+    drawBatches.clear();
+    for (size_t i = 0; i < groups.size(); i++) {
+        const Group& group = groups[i];
+        if (group.indexCount <= 0) { continue; }
+
+        if (!drawBatches.empty()) {
+            DrawBatch& ultimo = drawBatches.back();
+            if (groups[ultimo.group].sameMaterial(group) && ultimo.firstIndex + ultimo.indexCount == group.firstIndex) {
+                ultimo.indexCount += group.indexCount;  // estende o lote anterior
+                continue;
+            }
+        }
+        drawBatches.push_back({ i, group.firstIndex, (unsigned int)group.indexCount, 0 });
+    }
+
+    // Buffer de materiais: cada lote ocupa um trecho alinhado, ligado com glBindBufferRange no render
+    // (uma chamada por lote no lugar dos quatro glUniform de Ka, Kd, Ks e Ns)
+    size_t alinhamento = UniformBuffer::offsetAlignment();
+    size_t passo = (sizeof(MaterialUniforms) + alinhamento - 1) / alinhamento * alinhamento;
+    vector<char> materiais(drawBatches.size() * passo, 0);
+    for (size_t i = 0; i < drawBatches.size(); i++) {
+        drawBatches[i].materialOffset = i * passo;
+        MaterialUniforms uniforms = groups[drawBatches[i].group].materialUniforms();
+        memcpy(materiais.data() + drawBatches[i].materialOffset, &uniforms, sizeof(uniforms));
+    }
+    if (!materiais.empty()) { materialBuffer.create(materiais.size(), materiais.data(), GL_STATIC_DRAW); }
+
+    cout << "Malha: " << groups.size() << " grupos desenhados em " << drawBatches.size() << " lotes de material" << endl;
+    cout << endl;
+}
+
+
+// Envia as instâncias do quadro para o instanceVBO e os lotes de desenho da malha para a fila de renderização
+// Cada lote de material vira um único item instanciado, desenhado para todos os objetos que usam a malha
+// A ordenação por estado e o desenho são feitos por RenderQueue::flush
+void Mesh::submit(RenderQueue& queue, const Shader& shader, const vec3& objectColor) {
+
+    if (VAO == 0 || instances.empty()) { instances.clear(); return; }
+
+    // Envia as matrizes de modelo das instâncias (o buffer só é realocado quando precisa crescer)
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    if (instances.size() > instanceCapacity) {
+        instanceCapacity = instances.size() * 2;
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(mat4), nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(mat4), instances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    RenderStats::stateChanges += 2;
+    RenderStats::uniformUploads++;
+
+    for (const auto& batch : drawBatches) {
+        DrawItem item;
+        item.key            = 0;
+        item.shader         = &shader;
+        item.texture        = groups[batch.group].textureID;   // textura do material do lote
+        item.materialBuffer = &materialBuffer;                 // Ka, Kd, Ks e Ns do lote
+        item.materialOffset = batch.materialOffset;
+        item.VAO            = VAO;
+        item.indexType      = indexType;
+        item.firstIndex     = batch.firstIndex;
+        item.indexCount     = batch.indexCount;
+        item.instanceCount  = (unsigned int)instances.size();
+        item.objectColor    = objectColor;
+        queue.submit(item);
+    }
+
+    instances.clear();
 }
 
 
 // Limpa os dados da malha e libera recursos OpenGL
 void Mesh::cleanup() {
-    for (auto& group : groups) {
-        group.cleanup();
-    }
+    if (VAO != 0) { glDeleteVertexArrays(1, &VAO); VAO = 0; }
+    if (VBO != 0) { glDeleteBuffers(1, &VBO); VBO = 0; }
+    if (EBO != 0) { glDeleteBuffers(1, &EBO); EBO = 0; }
+    if (instanceVBO != 0) { glDeleteBuffers(1, &instanceVBO); instanceVBO = 0; }
+    instanceCapacity = 0;
+    instances.clear();
+    materialBuffer.cleanup();
+    // textureID dos grupos é gerenciado pelo cache em Texture::clearCache()
+
     groups.clear();
+    drawBatches.clear();
+    vertexData.clear();
+    indexData.clear();
+    bvh.clear();
     vertices.clear();
     texCoords.clear();
     normals.clear();
@@ -77,9 +318,17 @@ void Mesh::calculateBoundingBox() {
 }
 
 
-// Testa interseção do segmento (ray) com a bounding box (retorna true se houver interseção)
-bool Mesh::rayIntersect(const vec3& rayOrigin, const vec3& rayDirection, float& distance) const {
-    // Ray-AABB teste de interseção usando o método
+// Monta a BVH dos triângulos da malha (posições em vertexData, 8 floats por vértice)
+void Mesh::buildBVH() {
+    PROFILE_ZONE("Mesh::buildBVH");
+    bvh.build(vertexData.data(), vertexData.size() / 8, indexData.data(), indexData.size());
+}
+
+
+// Testa o raio contra a bounding box e, se passar, contra os triângulos da BVH
+// A direção não precisa ser normalizada (hit.distance é medido no parâmetro do raio)
+bool Mesh::rayIntersect(const vec3& rayOrigin, const vec3& rayDirection, float maxDistance, RayHit& hit) const {
+    // Ray-AABB: descarta rapidamente os raios que nem passam pela caixa da malha
     vec3 invDir = 1.0f / rayDirection;
     vec3 t1 = (boundingBox.pontoMinimo - rayOrigin) * invDir;
     vec3 t2 = (boundingBox.pontoMaximo - rayOrigin) * invDir;
@@ -90,10 +339,9 @@ bool Mesh::rayIntersect(const vec3& rayOrigin, const vec3& rayDirection, float&
     float tNear = std::max(std::max(tMin.x, tMin.y), tMin.z);
     float tFar = std::min(std::min(tMax.x, tMax.y), tMax.z);
     
-    if (tNear > tFar || tFar < 0.0f) {
+    if (tNear > tFar || tFar < 0.0f || tNear > maxDistance) {
         return false;
     }
     
-    distance = tNear > 0.0f ? tNear : tFar;
-    return true;
+    return bvh.intersect(rayOrigin, rayDirection, maxDistance, hit);
 }
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "MeshBVH.h"
+#include <cfloat>
+#include <algorithm>
+
+
+MeshBVH::MeshBVH() {}
+
+
+void MeshBVH::build(const float* vertexFloats, size_t vertexCount,
+                    const unsigned int* indices, size_t indexCount) {
+    clear();
+
+    size_t triCount = indexCount / 3;
+    if (triCount == 0) return;
+
+    // Triângulos em espaço do modelo (posição = 3 primeiros floats de cada vértice)
+    buildTriangles.resize(triCount);
+    centroids.resize(triCount);
+    order.resize(triCount);
+    for (size_t i = 0; i < triCount; i++) {
+        vec3 v[3];
+        for (int k = 0; k < 3; k++) {
+            unsigned int index = indices[i * 3 + k];
+            if (index >= vertexCount) { index = 0; }   // índice inválido: triângulo degenerado
+            const float* p = vertexFloats + (size_t)index * 8;
+            v[k] = vec3(p[0], p[1], p[2]);
+        }
+        buildTriangles[i] = { v[0], v[1], v[2] };
+        centroids[i] = (v[0] + v[1] + v[2]) * (1.0f / 3.0f);
+        order[i] = (unsigned int)i;
+    }
+
+    // No máximo 2N - 1 nós
+    nodes.reserve(triCount * 2);
+    nodes.push_back(Node());
+    nodes[0].leftFirst = 0;
+    nodes[0].count = (unsigned int)triCount;
+    updateBounds(nodes[0]);
+    subdivide(0, 1);
+
+    // Copia os triângulos (SoA) na ordem das folhas
+    triangles.resize(triCount);
+    for (size_t i = 0; i < triCount; i++) {
+        const Triangle& tri = buildTriangles[order[i]];
+        triangles.set(i, tri.v0, tri.v1, tri.v2);
+    }
+    triangleIds.swap(order);
+
+    vector<Triangle>().swap(buildTriangles);
+    vector<vec3>().swap(centroids);
+    vector<unsigned int>().swap(order);
+    nodes.shrink_to_fit();
+}
+
+
+void MeshBVH::clear() {
+    vector<Node>().swap(nodes);
+    triangles.clear();
+    vector<unsigned int>().swap(triangleIds);
+}
+
+
+void MeshBVH::updateBounds(Node& node) const {
+    node.boundsMin = vec3(FLT_MAX);
+    node.boundsMax = vec3(-FLT_MAX);
+    for (unsigned int i = 0; i < node.count; i++) {
+        const Triangle& tri = buildTriangles[order[node.leftFirst + i]];
+        node.boundsMin = min(node.boundsMin, min(tri.v0, min(tri.v1, tri.v2)));
+        node.boundsMax = max(node.boundsMax, max(tri.v0, max(tri.v1, tri.v2)));
+    }
+}
+
+
+// Divide o nó na melhor posição segundo a SAH; vira folha quando dividir não compensa
+void MeshBVH::subdivide(unsigned int nodeIndex, int depth) {
+    Node node = nodes[nodeIndex];
+    if (node.count <= LEAF_SIZE || depth >= MAX_DEPTH - 1) return;
+
+    int axis;
+    float splitPos;
+    float splitCost = findBestSplit(node, axis, splitPos);
+    float leafCost = node.count * area(node.boundsMin, node.boundsMax);
+    if (splitCost >= leafCost) return;
+
+    // Particiona os triângulos do nó (in-place) pelo centróide
+    unsigned int i = node.leftFirst;
+    unsigned int j = i + node.count - 1;
+    while (i <= j) {
+        if (centroids[order[i]][axis] < splitPos) {
+            i++;
+        } else {
+            std::swap(order[i], order[j]);
+            if (j == 0) break;
+            j--;
+        }
+    }
+
+    unsigned int leftCount = i - node.leftFirst;
+    if (leftCount == 0 || leftCount == node.count) return;
+
+    // Filhos lado a lado no vetor
+    unsigned int leftChild = (unsigned int)nodes.size();
+    nodes.push_back(Node());
+    nodes.push_back(Node());
+    nodes[leftChild].leftFirst = node.leftFirst;
+    nodes[leftChild].count = leftCount;
+    nodes[leftChild + 1].leftFirst = i;
+    nodes[leftChild + 1].count = node.count - leftCount;
+    updateBounds(nodes[leftChild]);
+    updateBounds(nodes[leftChild + 1]);
+
+    nodes[nodeIndex].leftFirst = leftChild;
+    nodes[nodeIndex].count = 0;
+
+    subdivide(leftChild, depth + 1);
+    subdivide(leftChild + 1, depth + 1);
+}
+
+
+// Avalia a SAH nas fronteiras entre BIN_COUNT bins de centróides em cada eixo; retorna o menor custo
+float MeshBVH::findBestSplit(const Node& node, int& axis, float& splitPos) const {
+    float bestCost = FLT_MAX;
+    axis = 0;
+    splitPos = 0.0f;
+
+    vec3 centroidMin(FLT_MAX), centroidMax(-FLT_MAX);
+    for (unsigned int i = 0; i < node.count; i++) {
+        const vec3& c = centroids[order[node.leftFirst + i]];
+        centroidMin = min(centroidMin, c);
+        centroidMax = max(centroidMax, c);
+    }
+
+    for (int a = 0; a < 3; a++) {
+        float boundsMin = centroidMin[a];
+        float boundsMax = centroidMax[a];
+        if (boundsMin == boundsMax) continue;
+
+        struct Bin { vec3 boundsMin = vec3(FLT_MAX), boundsMax = vec3(-FLT_MAX); unsigned int count = 0; };
+        Bin bins[BIN_COUNT];
+        float scale = BIN_COUNT / (boundsMax - boundsMin);
+        for (unsigned int i = 0; i < node.count; i++) {
+            unsigned int t = order[node.leftFirst + i];
+            int b = std::min(BIN_COUNT - 1, (int)((centroids[t][a] - boundsMin) * scale));
+            const Triangle& tri = buildTriangles[t];
+            bins[b].count++;
+            bins[b].boundsMin = min(bins[b].boundsMin, min(tri.v0, min(tri.v1, tri.v2)));
+            bins[b].boundsMax = max(bins[b].boundsMax, max(tri.v0, max(tri.v1, tri.v2)));
+        }
+
+        // Varredura da esquerda e da direita acumulando área e contagem de cada lado
+        float leftArea[BIN_COUNT - 1], rightArea[BIN_COUNT - 1];
+        unsigned int leftCount[BIN_COUNT - 1], rightCount[BIN_COUNT - 1];
+        vec3 leftMin(FLT_MAX), leftMax(-FLT_MAX), rightMin(FLT_MAX), rightMax(-FLT_MAX);
+        unsigned int leftSum = 0, rightSum = 0;
+        for (int i = 0; i < BIN_COUNT - 1; i++) {
+            leftSum += bins[i].count;
+            leftCount[i] = leftSum;
+            leftMin = min(leftMin, bins[i].boundsMin);
+            leftMax = max(leftMax, bins[i].boundsMax);
+            leftArea[i] = leftSum ? area(leftMin, leftMax) : 0.0f;
+
+            int r = BIN_COUNT - 1 - i;
+            rightSum += bins[r].count;
+            rightCount[r - 1] = rightSum;
+            rightMin = min(rightMin, bins[r].boundsMin);
+            rightMax = max(rightMax, bins[r].boundsMax);
+            rightArea[r - 1] = rightSum ? area(rightMin, rightMax) : 0.0f;
+        }
+
+        float binWidth = (boundsMax - boundsMin) / BIN_COUNT;
+        for (int i = 0; i < BIN_COUNT - 1; i++) {
+            float cost = leftCount[i] * leftArea[i] + rightCount[i] * rightArea[i];
+            if (cost < bestCost) {
+                bestCost = cost;
+                axis = a;
+                splitPos = boundsMin + binWidth * (i + 1);
+            }
+        }
+    }
+
+    return bestCost;
+}
+
+
+float MeshBVH::area(const vec3& boundsMin, const vec3& boundsMax) {
+    vec3 d = boundsMax - boundsMin;
+    return d.x * d.y + d.y * d.z + d.z * d.x;
+}
+
+
+// Teste de slabs; retorna a distância de entrada na caixa ou FLT_MAX se não houver interseção antes de tMax
+float MeshBVH::intersectBox(const Node& node, const vec3& origin, const vec3& invDir, float tMax) {
+    vec3 t1 = (node.boundsMin - origin) * invDir;
+    vec3 t2 = (node.boundsMax - origin) * invDir;
+    vec3 tNearV = min(t1, t2);
+    vec3 tFarV = max(t1, t2);
+
+    float tNear = std::max(std::max(tNearV.x, tNearV.y), std::max(tNearV.z, 0.0f));
+    float tFar = std::min(std::min(tFarV.x, tFarV.y), std::min(tFarV.z, tMax));
+    return tNear <= tFar ? tNear : FLT_MAX;
+}
+
+
+bool MeshBVH::intersect(const vec3& origin, const vec3& direction, float maxDistance, RayHit& hit) const {
+    if (nodes.empty()) return false;
+
+    vec3 invDir = 1.0f / direction;
+    float closest = maxDistance;
+    unsigned int closestTri = 0;
+    float closestU = 0.0f, closestV = 0.0f;
+    bool found = false;
+
+    if (intersectBox(nodes[0], origin, invDir, closest) == FLT_MAX) return false;
+
+    unsigned int stack[MAX_DEPTH];
+    int stackSize = 0;
+    unsigned int index = 0;
+
+    while (true) {
+        const Node& node = nodes[index];
+
+        if (node.count > 0) {   // folha: testa os triângulos juntos (Möller–Trumbore em SIMD)
+            long tri = CollisionKernels::rayVsTriangles(triangles, node.leftFirst, node.count,
+                                                        origin, direction, closest, closestU, closestV);
+            if (tri >= 0) {
+                closestTri = (unsigned int)tri;
+                found = true;
+            }
+        } else {                // nó interno: visita primeiro o filho mais próximo
+            unsigned int near = node.leftFirst;
+            unsigned int far = node.leftFirst + 1;
+            float distNear = intersectBox(nodes[near], origin, invDir, closest);
+            float distFar = intersectBox(nodes[far], origin, invDir, closest);
+            if (distFar < distNear) {
+                std::swap(near, far);
+                std::swap(distNear, distFar);
+            }
+
+            if (distNear != FLT_MAX) {
+                if (distFar != FLT_MAX) { stack[stackSize++] = far; }
+                index = near;
+                continue;
+            }
+        }
+
+        // Desempilha o próximo nó ainda mais próximo que o melhor triângulo encontrado
+        bool next = false;
+        while (stackSize > 0) {
+            index = stack[--stackSize];
+            if (intersectBox(nodes[index], origin, invDir, closest) != FLT_MAX) { next = true; break; }
+        }
+        if (!next) break;
+    }
+
+    if (!found) return false;
+
+    unsigned int t = closestTri;
+    hit.distance = closest;
+    hit.triangle = triangleIds[t];
+    hit.u = closestU;
+    hit.v = closestV;
+    hit.normal = normalize(cross(vec3(triangles.e1x[t], triangles.e1y[t], triangles.e1z[t]),
+                                 vec3(triangles.e2x[t], triangles.e2y[t], triangles.e2z[t])));
+    return true;
+}
@@ -0,0 +1,359 @@
+#include "MeshCache.h"
+#include "Mesh.h"
+#include "MappedFile.h"
+#include "MeshOptimizer.h"
+#include "Profiler.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <chrono>
+#include <filesystem>
+#include <algorithm>
+
+// Formato do arquivo (valores binários na ordem de bytes da máquina):
+//   "OBJC" | versão | tamanho do OBJ | data de modificação do OBJ | caminho do OBJ | flags
+//   nº de dependências | para cada dependência (MTL e texturas): caminho, tamanho, data de modificação
+//   bounding box (pontoMinimo, pontoMaximo)
+//   nº de materiais | para cada material: nome, Ka, Kd, Ks, Ns, map_Kd
+//   nº de grupos    | para cada grupo: nome, material, baseVertex, nº de vértices, firstIndex, nº de índices
+//   nº de floats da malha, (alinhamento 4) floats | nº de índices da malha, (alinhamento 4) índices de 32 bits
+// Strings são gravadas como <uint32 tamanho><caracteres>
+
+static const char CACHE_MAGIC[4] = {'O', 'B', 'J', 'C'};
+
+// Flags do cabeçalho: como os grupos gravados foram processados
+static const uint32_t FLAG_OTIMIZADO = 1;   // triângulos/vértices reordenados pelo MeshOptimizer
+
+bool MeshCache::enabled = true;
+
+
+// Funções auxiliares de gravação: acrescentam os dados ao buffer que será gravado no arquivo
+template <typename T>
+static void writeValue(vector<char>& buffer, const T& value) {
+    const char* bytes = (const char*)&value;
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+// Grava a quantidade de elementos e o conteúdo do vetor, alinhado em múltiplo de 4 bytes
+template <typename T>
+static void writeArray(vector<char>& buffer, const vector<T>& values) {
+    writeValue(buffer, (uint32_t)values.size());
+    buffer.resize((buffer.size() + 3) & ~(size_t)3, 0);
+    const char* bytes = (const char*)values.data();
+    buffer.insert(buffer.end(), bytes, bytes + values.size() * sizeof(T));
+}
+
+static void writeString(vector<char>& buffer, const string& str) {
+    writeValue(buffer, (uint32_t)str.size());
+    buffer.insert(buffer.end(), str.begin(), str.end());
+}
+
+static void writeMaterial(vector<char>& buffer, const Material& material) {
+    writeString(buffer, material.name);
+    writeValue(buffer, material.Ka);
+    writeValue(buffer, material.Kd);
+    writeValue(buffer, material.Ks);
+    writeValue(buffer, material.Ns);
+    writeString(buffer, material.map_Kd);
+}
+
+
+// Percorre o cache mapeado em memória, verificando os limites do arquivo a cada leitura
+// (um cache truncado ou corrompido apenas marca "ok = false" e é descartado)
+struct CacheReader {
+    const char* begin;
+    const char* p;
+    const char* end;
+    bool ok;
+
+    CacheReader(const char* data, size_t size) : begin(data), p(data), end(data + size), ok(data != nullptr) {}
+
+    template <typename T>
+    T read() {
+        T value{};
+        if (!ok || (size_t)(end - p) < sizeof(T)) { ok = false; return value; }
+        memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return value;
+    }
+
+    string readString() {
+        uint32_t length = read<uint32_t>();
+        if (!ok || (size_t)(end - p) < length) { ok = false; return string(); }
+        string str(p, length);
+        p += length;
+        return str;
+    }
+
+    Material readMaterial() {
+        Material material;
+        material.name   = readString();
+        material.Ka     = read<vec3>();
+        material.Kd     = read<vec3>();
+        material.Ks     = read<vec3>();
+        material.Ns     = read<float>();
+        material.map_Kd = readString();
+        return material;
+    }
+
+    // Retorna um ponteiro para "count" valores de 4 bytes (floats ou índices) dentro do próprio
+    // arquivo mapeado (sem cópia)
+    template <typename T>
+    const T* readArray(uint32_t count) {
+        static_assert(sizeof(T) == 4, "arrays do cache sao alinhados em 4 bytes");
+        p = begin + ((p - begin + 3) & ~(ptrdiff_t)3);  // arrays gravados em posição múltipla de 4
+        if (!ok || p > end || (size_t)(end - p) / sizeof(T) < count) { ok = false; return nullptr; }
+        const T* values = (const T*)p;
+        p += count * sizeof(T);
+        return values;
+    }
+};
+
+
+string MeshCache::cachePath(const string& objFilePath) {
+    return objFilePath + ".meshcache";
+}
+
+
+bool MeshCache::sourceInfo(const string& objFilePath, uint64_t& size, int64_t& mtime) {
+    error_code erro;
+    size = (uint64_t)filesystem::file_size(objFilePath, erro);
+    if (erro) { return false; }
+    auto lastWrite = filesystem::last_write_time(objFilePath, erro);
+    if (erro) { return false; }
+    mtime = (int64_t)lastWrite.time_since_epoch().count();
+    return true;
+}
+
+
+vector<string> MeshCache::dependencies(const Mesh& mesh) {
+    vector<string> paths = mesh.materialFiles;
+    for (const auto& group : mesh.groups) {
+        if (!group.material.hasTexture()) { continue; }
+        string texturePath = mesh.modelDirectory + "/" + group.material.map_Kd;
+        if (find(paths.begin(), paths.end(), texturePath) == paths.end()) { paths.push_back(texturePath); }
+    }
+    return paths;
+}
+
+
+void MeshCache::dependencyInfo(const string& path, uint64_t& size, int64_t& mtime) {
+    if (!sourceInfo(path, size, mtime)) {
+        size = MISSING_FILE;
+        mtime = 0;
+    }
+}
+
+
+// Carrega a malha a partir do arquivo de cache mapeado em memória
+// Só lê e copia os dados (sem chamadas OpenGL): o envio aos buffers é feito depois, por Mesh::upload
+bool MeshCache::load(const string& objFilePath, Mesh& mesh) {
+
+    if (!enabled) { return false; }
+    PROFILE_ZONE_DETAIL("MeshCache::load", objFilePath);
+
+    auto inicio = chrono::steady_clock::now();  // para medir o tempo de leitura do cache
+
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    if (!sourceInfo(objFilePath, sourceSize, sourceMtime)) { return false; }
+
+    MappedFile cacheFile;
+    if (!cacheFile.open(cachePath(objFilePath))) { return false; }   // ainda não há cache
+
+    CacheReader reader(cacheFile.data(), cacheFile.size());
+
+    // Cabeçalho: confere a versão do formato e a chave (caminho, tamanho e data do OBJ e das dependências)
+    char magic[4];
+    for (char& c : magic) { c = reader.read<char>(); }
+    uint32_t version    = reader.read<uint32_t>();
+    uint64_t cachedSize = reader.read<uint64_t>();
+    int64_t cachedMtime = reader.read<int64_t>();
+    string cachedPath   = reader.readString();
+    uint32_t flags      = reader.read<uint32_t>();
+
+    // O cache também é regravado se foi gerado com a otimização ligada e agora ela está desligada (ou o contrário)
+    bool otimizado = (flags & FLAG_OTIMIZADO) != 0;
+
+    if (!reader.ok || memcmp(magic, CACHE_MAGIC, 4) != 0 || version != VERSION ||
+        cachedSize != sourceSize || cachedMtime != sourceMtime || cachedPath != objFilePath ||
+        otimizado != MeshOptimizer::enabled) {
+        cout << "Cache " << cachePath(objFilePath) << " desatualizado, relendo o OBJ" << endl;
+        return false;
+    }
+
+    // Um MTL ou textura alterado (ou criado, ou removido) depois da gravação também invalida o cache
+    uint32_t dependencyCount = reader.read<uint32_t>();
+    if (!reader.ok || dependencyCount > cacheFile.size()) {
+        cerr << "Cache " << cachePath(objFilePath) << " corrompido, relendo o OBJ" << endl;
+        return false;
+    }
+    for (uint32_t i = 0; i < dependencyCount; i++) {
+        string path          = reader.readString();
+        uint64_t cachedBytes = reader.read<uint64_t>();
+        int64_t cachedTime   = reader.read<int64_t>();
+        if (!reader.ok) { break; }
+
+        uint64_t size;
+        int64_t mtime;
+        dependencyInfo(path, size, mtime);
+        if (size != cachedBytes || mtime != cachedTime) {
+            cout << "Cache " << cachePath(objFilePath) << " desatualizado (" << path << " alterado), relendo o OBJ" << endl;
+            return false;
+        }
+    }
+
+    BoundingBox boundingBox;
+    boundingBox.pontoMinimo = reader.read<vec3>();
+    boundingBox.pontoMaximo = reader.read<vec3>();
+
+    map<string, Material> materials;
+    uint32_t materialCount = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < materialCount && reader.ok; i++) {
+        Material material = reader.readMaterial();
+        materials[material.name] = material;
+    }
+
+    // Lê todos os grupos e arrays antes de criar os buffers, para não deixar a malha pela metade
+    // se o cache estiver corrompido
+    uint32_t groupCount = reader.read<uint32_t>();
+    if (!reader.ok || groupCount > cacheFile.size()) {  // contagem impossível para o tamanho do arquivo
+        cerr << "Cache " << cachePath(objFilePath) << " corrompido, relendo o OBJ" << endl;
+        return false;
+    }
+    vector<Group> groups(groupCount);
+    for (auto& group : groups) {
+        group.name        = reader.readString();
+        group.material    = reader.readMaterial();
+        group.baseVertex  = reader.read<uint32_t>();
+        group.vertexCount = (int)reader.read<uint32_t>();
+        group.firstIndex  = reader.read<uint32_t>();
+        group.indexCount  = (int)reader.read<uint32_t>();
+        if (!reader.ok) { break; }
+    }
+
+    uint32_t floatCount = reader.read<uint32_t>();
+    const float* vertexData = reader.readArray<float>(floatCount);
+    uint32_t indexCount = reader.read<uint32_t>();
+    const unsigned int* indexData = reader.readArray<unsigned int>(indexCount);
+
+    // As faixas dos grupos precisam caber nos arrays da malha
+    for (const auto& group : groups) {
+        if (!reader.ok) { break; }
+        if ((uint64_t)group.firstIndex + (uint32_t)group.indexCount > indexCount ||
+            ((uint64_t)group.baseVertex + (uint32_t)group.vertexCount) * 8 > floatCount) {
+            reader.ok = false;
+        }
+    }
+
+    // Os índices (já somados ao baseVertex do grupo) precisam apontar para vértices existentes: um índice
+    // fora do VBO levaria a BVH e o desenho a ler além dos arrays
+    uint32_t vertexCount = floatCount / 8;
+    for (uint32_t i = 0; i < indexCount && reader.ok; i++) {
+        if (indexData[i] >= vertexCount) { reader.ok = false; }
+    }
+
+    if (!reader.ok) {
+        cerr << "Cache " << cachePath(objFilePath) << " corrompido, relendo o OBJ" << endl;
+        return false;
+    }
+
+    mesh.cleanup();
+    mesh.boundingBox = boundingBox;
+    mesh.materials = move(materials);
+    mesh.groups = move(groups);
+
+    // copia os vértices e os índices do arquivo mapeado, como se tivessem sido montados a partir do OBJ
+    mesh.vertexData.assign(vertexData, vertexData + floatCount);
+    mesh.indexData.assign(indexData, indexData + indexCount);
+
+    double tempoMs = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+    cout << "Malha " << objFilePath << " carregada do cache em " << tempoMs << " ms ("
+         << mesh.groups.size() << " grupos)" << endl;
+
+    return true;
+}
+
+
+// Grava o cache da malha recém lida do OBJ
+// As faixas dos grupos e os vértices/índices da malha (Mesh::vertexData/indexData) são gravados
+// exatamente como foram enviados à OpenGL
+bool MeshCache::save(const string& objFilePath, const Mesh& mesh) {
+
+    if (!enabled) { return false; }
+
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    if (!sourceInfo(objFilePath, sourceSize, sourceMtime)) { return false; }
+
+    vector<char> buffer;
+
+    buffer.insert(buffer.end(), CACHE_MAGIC, CACHE_MAGIC + 4);
+    writeValue(buffer, (uint32_t)VERSION);
+    writeValue(buffer, sourceSize);
+    writeValue(buffer, sourceMtime);
+    writeString(buffer, objFilePath);
+    writeValue(buffer, MeshOptimizer::enabled ? FLAG_OTIMIZADO : 0u);
+
+    vector<string> paths = dependencies(mesh);
+    writeValue(buffer, (uint32_t)paths.size());
+    for (const string& path : paths) {
+        uint64_t size;
+        int64_t mtime;
+        dependencyInfo(path, size, mtime);
+        writeString(buffer, path);
+        writeValue(buffer, size);
+        writeValue(buffer, mtime);
+    }
+
+    writeValue(buffer, mesh.boundingBox.pontoMinimo);
+    writeValue(buffer, mesh.boundingBox.pontoMaximo);
+
+    writeValue(buffer, (uint32_t)mesh.materials.size());
+    for (const auto& material : mesh.materials) {
+        writeMaterial(buffer, material.second);
+    }
+
+    writeValue(buffer, (uint32_t)mesh.groups.size());
+    for (const auto& group : mesh.groups) {
+        writeString(buffer, group.name);
+        writeMaterial(buffer, group.material);
+        writeValue(buffer, (uint32_t)group.baseVertex);
+        writeValue(buffer, (uint32_t)group.vertexCount);
+        writeValue(buffer, (uint32_t)group.firstIndex);
+        writeValue(buffer, (uint32_t)group.indexCount);
+    }
+    writeArray(buffer, mesh.vertexData);
+    writeArray(buffer, mesh.indexData);
+
+    // Grava em um arquivo temporário e o renomeia sobre o cache: quem está mapeando o cache antigo (outra
+    // instância carregando a mesma cena) nunca o vê truncado, e uma gravação interrompida não deixa um cache
+    // parcial. O sufixo é único por gravação, para que duas instâncias não escrevam no mesmo temporário
+    string path = cachePath(objFilePath);
+    string temporario = path + "." + to_string(chrono::steady_clock::now().time_since_epoch().count()) + ".tmp";
+    ofstream cacheFile(temporario, ios::binary | ios::trunc);
+    if (!cacheFile.is_open()) {
+        cerr << "Aviso: Nao foi possivel gravar o cache " << path << endl;
+        return false;
+    }
+
+    cacheFile.write(buffer.data(), buffer.size());
+    cacheFile.close();
+
+    if (!cacheFile) {   // gravação incompleta: remove o temporário, o cache anterior (se houver) continua valendo
+        remove(temporario.c_str());
+        return false;
+    }
+
+    error_code erro;
+    filesystem::rename(temporario, path, erro);
+    if (erro) {
+        cerr << "Aviso: Nao foi possivel substituir o cache " << path << ": " << erro.message() << endl;
+        remove(temporario.c_str());
+        return false;
+    }
+
+    cout << "Cache da malha gravado em " << path << " (" << buffer.size() / 1024 << " KB)" << endl;
+    return true;
+}
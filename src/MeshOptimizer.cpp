@@ -0,0 +1,241 @@
+#include "MeshOptimizer.h"
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <glm/glm.hpp>
+
+using namespace glm;
+
+bool MeshOptimizer::enabled = true;
+
+
+// Simula um cache FIFO de "cacheSize" vértices e retorna quantos vértices precisariam ser transformados
+// (um vértice está no cache se foi inserido há menos de "cacheSize" falhas)
+static size_t countCacheMisses(const vector<unsigned int>& indices, unsigned int cacheSize) {
+
+    if (indices.empty()) { return 0; }
+
+    const size_t NUNCA = (size_t)-1;
+    vector<size_t> inseridoEm(*max_element(indices.begin(), indices.end()) + 1, NUNCA);
+    size_t falhas = 0;
+
+    for (unsigned int v : indices) {
+        if (inseridoEm[v] == NUNCA || falhas - inseridoEm[v] >= cacheSize) {
+            inseridoEm[v] = falhas;     // o vértice entra no fim da fila do cache
+            falhas++;
+        }
+    }
+    return falhas;
+}
+
+
+float MeshOptimizer::calculateACMR(const vector<unsigned int>& indices, unsigned int cacheSize) {
+    size_t triangulos = indices.size() / 3;
+    return triangulos ? (float)countCacheMisses(indices, cacheSize) / triangulos : 0.0f;
+}
+
+
+float MeshOptimizer::calculateATVR(const vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize) {
+    return vertexCount ? (float)countCacheMisses(indices, cacheSize) / vertexCount : 0.0f;
+}
+
+
+// Tipsify: percorre a malha em "leques" em torno de um vértice (fanning vertex), emitindo todos os
+// triângulos ainda não emitidos que o usam. O próximo vértice é escolhido entre os vizinhos recém
+// emitidos que ainda estarão no cache; se nenhum servir, volta pela pilha de "becos sem saída" (dead-ends)
+// ou pega o próximo vértice com triângulos pendentes na ordem original
+void MeshOptimizer::optimizeVertexCache(vector<unsigned int>& indices, size_t vertexCount,
+                                        vector<size_t>& clusters, unsigned int cacheSize) {
+
+    clusters.clear();
+    size_t numTriangles = indices.size() / 3;
+    if (numTriangles == 0 || vertexCount == 0) { return; }
+
+    // Adjacência vértice -> triângulos (formato compacto: offsets + lista)
+    vector<unsigned int> livres(vertexCount, 0);    // triângulos ainda não emitidos que usam cada vértice
+    for (unsigned int v : indices) { livres[v]++; }
+
+    vector<size_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) { offsets[v + 1] = offsets[v] + livres[v]; }
+
+    vector<unsigned int> adjacencia(indices.size());
+    vector<size_t> preenchidos(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < numTriangles; t++) {
+        for (int c = 0; c < 3; c++) { adjacencia[preenchidos[indices[t * 3 + c]]++] = (unsigned int)t; }
+    }
+
+    vector<unsigned int> saida;
+    saida.reserve(indices.size());
+
+    vector<size_t> cacheTime(vertexCount, 0);   // "instante" em que o vértice entrou no cache
+    vector<bool> emitido(numTriangles, false);
+    vector<unsigned int> deadEnds;              // pilha de vértices recém usados (para retomar após um beco sem saída)
+    vector<unsigned int> candidatos;
+    size_t instante = cacheSize + 1;            // relógio do cache (começa "vazio")
+    size_t cursor = 0;                          // próximo vértice a testar na ordem original
+
+    // Retoma a partir da pilha de dead-ends ou, se vazia, do próximo vértice com triângulos pendentes
+    auto skipDeadEnd = [&]() -> long long {
+        while (!deadEnds.empty()) {
+            unsigned int d = deadEnds.back();
+            deadEnds.pop_back();
+            if (livres[d] > 0) { return d; }
+        }
+        while (cursor < vertexCount) {
+            if (livres[cursor] > 0) { return (long long)cursor; }
+            cursor++;
+        }
+        return -1;
+    };
+
+    long long fanning = skipDeadEnd();
+    clusters.push_back(0);
+
+    while (fanning >= 0) {
+
+        candidatos.clear();
+
+        // Emite todos os triângulos pendentes em torno do vértice "fanning"
+        for (size_t a = offsets[fanning]; a < offsets[fanning + 1]; a++) {
+            unsigned int t = adjacencia[a];
+            if (emitido[t]) { continue; }
+
+            for (int c = 0; c < 3; c++) {
+                unsigned int v = indices[t * 3 + c];
+                saida.push_back(v);
+                deadEnds.push_back(v);
+                candidatos.push_back(v);
+                livres[v]--;
+                if (instante - cacheTime[v] > cacheSize) {  // o vértice não estava no cache: entra agora
+                    cacheTime[v] = instante;
+                    instante++;
+                }
+            }
+            emitido[t] = true;
+        }
+
+        // Escolhe o próximo vértice: o candidato com triângulos pendentes que ficará mais tempo no cache
+        long long proximo = -1;
+        long long melhor = -1;
+        for (unsigned int v : candidatos) {
+            if (livres[v] == 0) { continue; }
+            long long prioridade = 0;
+            if (instante - cacheTime[v] + 2 * livres[v] <= cacheSize) {  // ainda estará no cache após o leque
+                prioridade = instante - cacheTime[v];
+            }
+            if (prioridade > melhor) {
+                melhor = prioridade;
+                proximo = v;
+            }
+        }
+
+        if (proximo == -1) {                    // beco sem saída: inicia um novo cluster
+            proximo = skipDeadEnd();
+            if (proximo >= 0 && saida.size() / 3 > clusters.back()) { clusters.push_back(saida.size() / 3); }
+        }
+        fanning = proximo;
+    }
+
+    indices.swap(saida);
+}
+
+
+// Ordena os clusters pela "exterioridade": produto escalar entre a normal média do cluster e o vetor
+// do centro do modelo até o centro do cluster. Clusters externos e voltados para fora são desenhados
+// primeiro e escondem (via depth test) os internos, que deixam de gerar fragmentos
+void MeshOptimizer::optimizeOverdraw(vector<unsigned int>& indices, const vector<float>& vertices,
+                                     const vector<size_t>& clusters) {
+
+    size_t numTriangles = indices.size() / 3;
+    if (clusters.size() < 2) { return; }
+
+    auto posicao = [&](unsigned int v) { return vec3(vertices[v * 8], vertices[v * 8 + 1], vertices[v * 8 + 2]); };
+
+    // Centro do modelo ponderado pela área dos triângulos
+    vec3 centroModelo(0.0f);
+    float areaTotal = 0.0f;
+    for (size_t t = 0; t < numTriangles; t++) {
+        vec3 a = posicao(indices[t * 3]), b = posicao(indices[t * 3 + 1]), c = posicao(indices[t * 3 + 2]);
+        float area = length(cross(b - a, c - a));
+        centroModelo += (a + b + c) * (area / 3.0f);
+        areaTotal += area;
+    }
+    if (areaTotal > 0.0f) { centroModelo /= areaTotal; }
+
+    // Chave de ordenação de cada cluster
+    vector<float> chave(clusters.size());
+    for (size_t k = 0; k < clusters.size(); k++) {
+        size_t fim = (k + 1 < clusters.size()) ? clusters[k + 1] : numTriangles;
+        vec3 centro(0.0f), normal(0.0f);
+        float area = 0.0f;
+        for (size_t t = clusters[k]; t < fim; t++) {
+            vec3 a = posicao(indices[t * 3]), b = posicao(indices[t * 3 + 1]), c = posicao(indices[t * 3 + 2]);
+            vec3 n = cross(b - a, c - a);     // normal ponderada pela área
+            float areaTri = length(n);
+            normal += n;
+            centro += (a + b + c) * (areaTri / 3.0f);
+            area += areaTri;
+        }
+        if (area > 0.0f) { centro /= area; }
+        float len = length(normal);
+        chave[k] = (len > 0.0f) ? dot(centro - centroModelo, normal / len) : 0.0f;
+    }
+
+    vector<size_t> ordem(clusters.size());
+    iota(ordem.begin(), ordem.end(), 0);
+    stable_sort(ordem.begin(), ordem.end(), [&](size_t a, size_t b) { return chave[a] > chave[b]; });
+
+    vector<unsigned int> saida;
+    saida.reserve(indices.size());
+    for (size_t k : ordem) {
+        size_t fim = (k + 1 < clusters.size()) ? clusters[k + 1] : numTriangles;
+        saida.insert(saida.end(), indices.begin() + clusters[k] * 3, indices.begin() + fim * 3);
+    }
+    indices.swap(saida);
+}
+
+
+// Renumera os vértices na ordem do primeiro uso, para que a GPU leia o VBO de forma quase sequencial
+// Vértices não referenciados por nenhum índice são mantidos no final
+void MeshOptimizer::optimizeVertexFetch(vector<float>& vertices, vector<unsigned int>& indices) {
+
+    size_t vertexCount = vertices.size() / 8;
+    const unsigned int SEM_USO = (unsigned int)-1;
+    vector<unsigned int> novoIndice(vertexCount, SEM_USO);
+    vector<float> saida;
+    saida.reserve(vertices.size());
+
+    auto copiar = [&](unsigned int v) {
+        novoIndice[v] = (unsigned int)(saida.size() / 8);
+        saida.insert(saida.end(), vertices.begin() + v * 8, vertices.begin() + v * 8 + 8);
+    };
+
+    for (unsigned int& v : indices) {
+        if (novoIndice[v] == SEM_USO) { copiar(v); }
+        v = novoIndice[v];
+    }
+    for (size_t v = 0; v < vertexCount; v++) {
+        if (novoIndice[v] == SEM_USO) { copiar((unsigned int)v); }
+    }
+
+    vertices.swap(saida);
+}
+
+
+void MeshOptimizer::optimize(vector<float>& vertices, vector<unsigned int>& indices, const string& groupName) {
+
+    if (indices.size() < 3) { return; }
+
+    size_t vertexCount = vertices.size() / 8;
+    float acmrAntes = calculateACMR(indices);
+    float atvrAntes = calculateATVR(indices, vertexCount);
+
+    vector<size_t> clusters;
+    optimizeVertexCache(indices, vertexCount, clusters);
+    optimizeOverdraw(indices, vertices, clusters);
+    optimizeVertexFetch(vertices, indices);
+
+    cout << "Grupo \"" << groupName << "\" otimizado: ACMR " << acmrAntes << " -> " << calculateACMR(indices)
+         << ", ATVR " << atvrAntes << " -> " << calculateATVR(indices, vertexCount)
+         << " (" << clusters.size() << " clusters)" << endl;
+}
@@ -0,0 +1,25 @@
+#include "ModelRegistry.h"
+#include <iostream>
+
+map<string, shared_ptr<Mesh>> ModelRegistry::registry;
+
+
+shared_ptr<Mesh> ModelRegistry::load(string& modelPath) {
+
+    auto it = registry.find(modelPath);
+    if (it != registry.end()) {
+        cout << "Modelo " << modelPath << " ja carregado, malha compartilhada" << endl;
+        return it->second;
+    }
+
+    auto mesh = make_shared<Mesh>();
+    if (!mesh->readObjectModel(modelPath)) { return nullptr; }
+
+    registry[modelPath] = mesh;
+    return mesh;
+}
+
+
+void ModelRegistry::clear() {
+    registry.clear();   // o destrutor de cada malha libera seus buffers OpenGL
+}
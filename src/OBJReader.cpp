@@ -3,22 +3,136 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <chrono>
+#include <string_view>
+#include <thread>
+#include <iterator>
+#include "MappedFile.h"
+#include "Profiler.h"
+
+// Funções auxiliares do tokenizador: percorrem o arquivo mapeado em memória sem copiar dados
+static inline bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+
+static inline const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && isBlank(*p)) { ++p; }
+    return p;
+}
+
+static inline const char* skipToken(const char* p, const char* end) {
+    while (p < end && !isBlank(*p)) { ++p; }
+    return p;
+}
+
+// Retorna o próximo token (palavra) da linha e avança o cursor "p" para depois dele
+static inline string_view nextToken(const char*& p, const char* end) {
+    const char* tokenStart = skipBlanks(p, end);
+    p = skipToken(tokenStart, end);
+    return string_view(tokenStart, p - tokenStart);
+}
+
+
+// Resultado da leitura de um bloco (chunk) do arquivo OBJ
+// Cada bloco é lido de forma independente (em paralelo, quando há mais de um) e depois
+// juntado aos vetores da Mesh na ordem do arquivo, o que preserva a numeração global dos
+// índices e os limites de grupos/materiais, exatamente como na leitura serial
+struct OBJChunk {
+    vector<vec3> vertices;
+    vector<vec2> texCoords;
+    vector<vec3> normals;
+    vector<Face> faces;     // faces já trianguladas, na ordem em que aparecem no bloco
+
+    // Comandos que alteram o estado da leitura ("g"/"o", "usemtl", "mtllib") e a primeira
+    // face lida antes de qualquer grupo do bloco (cria o grupo "default" se ainda não houver grupo)
+    // faceIndex = quantidade de faces do bloco lidas antes do comando
+    enum Tipo { GRUPO, MATERIAL, MTLLIB, FACE_SEM_GRUPO };
+    struct Comando {
+        Tipo tipo;
+        string nome;
+        size_t faceIndex;
+    };
+    vector<Comando> comandos;
+};
+
+
+// Lê as linhas do intervalo [cursor, fileEnd) para o bloco "chunk"
+// Não acessa nada fora do bloco, por isso pode ser executada em várias threads ao mesmo tempo
+static void parseChunk(const char* cursor, const char* fileEnd, OBJChunk& chunk) {
+
+    Face face;  // face temporária reutilizada em todas as linhas "f" (mantém a capacidade dos vetores de índices)
+    bool temGrupo = false;  // já houve "g"/"o" neste bloco?
+
+    while (cursor < fileEnd) { // Lê o bloco linha por linha: [cursor, lineEnd) é a linha atual
+        
+        const char* lineEnd = (const char*)memchr(cursor, '\n', fileEnd - cursor);
+        if (!lineEnd) { lineEnd = fileEnd; }    // última linha sem '\n'
+
+        const char* p = skipBlanks(cursor, lineEnd);    // Ignora espaços em branco no início da linha
+        cursor = (lineEnd < fileEnd) ? lineEnd + 1 : fileEnd;   // próxima linha
+
+        if (p == lineEnd || *p == '#') { continue; } // Ignora linhas vazias e de comentários "#"
+
+        string_view prefix = nextToken(p, lineEnd);  // Lê o prefixo da linha (v, vt, vn, f, etc.)
+
+        if (prefix == "v") {                // adiciona as coord. do vértice (vec3), presentes na linha, ao vetor de
+            OBJReader::parseVertice(p, lineEnd, chunk.vertices);   // coordenadas dos vértices do bloco
+        }
+        else if (prefix == "vt") {          // adiciona as coord. de textura (vec2), presentes na linha, ao vetor de
+            OBJReader::parseTexCoord(p, lineEnd, chunk.texCoords); // coordenadas de textura do bloco
+        }
+        else if (prefix == "vn") {          // adiciona as normais (vec3), presentes na linha, ao vetor de    
+            OBJReader::parseNormal(p, lineEnd, chunk.normals);     // normais do bloco
+        }
+        else if (prefix == "f") {   // Adiciona os indices que referenciam os vértices de uma face ao bloco.
+                                    // No arquivo .obj cada vertice é representado por índices no formato:
+                                    // vertice/texCoord/normal -> ex.: f 1/1/1 2/2/1 3/3/1 4/4/1
+            if (!temGrupo) {        // face antes de qualquer grupo do bloco: registra uma única vez
+                chunk.comandos.push_back({OBJChunk::FACE_SEM_GRUPO, string(), chunk.faces.size()});
+                temGrupo = true;
+            }
+            
+            OBJReader::parseFace(p, lineEnd, face); // popula a face com os INDICES lidos na linha
+            face.triangulate(chunk.faces);          // "triangula" a face e guarda os triângulos no bloco
+        }
+        else if (prefix == "mtllib") { // O arquivo MTL é lido na junção dos blocos, na ordem do arquivo
+            chunk.comandos.push_back({OBJChunk::MTLLIB, string(nextToken(p, lineEnd)), chunk.faces.size()});
+        }
+        else if (prefix == "g" || prefix == "o") {  // Inicia um novo grupo
+            chunk.comandos.push_back({OBJChunk::GRUPO, string(nextToken(p, lineEnd)), chunk.faces.size()});
+            temGrupo = true;
+        }
+        else if (prefix == "usemtl") { // Define o material atual
+            chunk.comandos.push_back({OBJChunk::MATERIAL, string(nextToken(p, lineEnd)), chunk.faces.size()});
+        }
+    }
+}
+
 
 // Realiza a leitura de um arquivo OBJ, preenchendo os vetores passados por referência
 // Uso: System::loadSceneObjects -> Object3D::loadObject -> Mesh::readObjectModel -> OBJReader::readFileOBJ
 // As classes anteriores "chamam" este método para carregar o modelo OBJ
 // Os vetores de armazenamento de vértices, textura, normais e grupos são da classe Mesh
 // e são passados como referência para este método, que os preenche
+// O arquivo é mapeado em memória (MappedFile) e cada linha é analisada diretamente no buffer
+// mapeado, sem getline/istringstream e sem alocações por linha
+// Arquivos grandes são divididos em blocos alinhados em '\n', lidos em paralelo (parseChunk)
+// e juntados em ordem, com resultado idêntico ao da leitura serial
 bool OBJReader::readFileOBJ(const string& objFilePath,
                             vector<vec3>& vertices,
                             vector<vec2>& texCoords,
                             vector<vec3>& normals,
                             vector<Group>& groups,
-                            map<string, Material>& materials)          {
+                            map<string, Material>& materials,
+                            unsigned int numThreads,
+                            vector<string>* materialFiles)    {
+    PROFILE_ZONE_DETAIL("OBJReader::readFileOBJ", objFilePath);
+
+    auto inicio = chrono::steady_clock::now();  // para medir o tempo de leitura do arquivo
 
-    ifstream objFile(objFilePath);    // Abre o arquivo OBJ para leitura
+    MappedFile objFile;     // Mapeia o arquivo OBJ em memória para leitura
 
-    if (!objFile.is_open()) {  // Debug
+    if (!objFile.open(objFilePath)) {  // Debug
         cerr << "Falha ao abrir arquivo OBJ: " << objFilePath << endl;  cout << endl;
         return false;
     }
@@ -28,63 +142,93 @@ bool OBJReader::readFileOBJ(const string& objFilePath,
     normals.clear();
     groups.clear();
     materials.clear();
-    
-    string objFileLine;  // variável temporária para armazenar cada linha lida do arquivo de configuração .obj
+
+    // Define a quantidade de blocos: no modo automático (numThreads = 0) usa um bloco por núcleo,
+    // com pelo menos PARALLEL_MIN_CHUNK bytes por bloco (arquivos pequenos são lidos de forma serial)
+    size_t numChunks = numThreads;
+    if (numChunks == 0) {
+        numChunks = std::max(1u, thread::hardware_concurrency());
+        numChunks = std::min(numChunks, std::max<size_t>(1, objFile.size() / PARALLEL_MIN_CHUNK));
+    }
+
+    const char* fileBegin = objFile.data();
+    const char* fileEnd   = fileBegin + objFile.size();
+
+    // Divide o arquivo em blocos de tamanho aproximado, ajustando cada divisão para o início de uma linha
+    vector<const char*> limites(numChunks + 1, fileEnd);
+    limites[0] = fileBegin;
+    for (size_t i = 1; i < numChunks; i++) {
+        const char* p = std::max(limites[i - 1], fileBegin + objFile.size() * i / numChunks);
+        const char* quebra = (p < fileEnd) ? (const char*)memchr(p, '\n', fileEnd - p) : nullptr;
+        limites[i] = quebra ? quebra + 1 : fileEnd;
+    }
+
+    // Lê os blocos: o primeiro na thread atual e os demais em threads auxiliares
+    vector<OBJChunk> chunks(numChunks);
+    vector<thread> workers;
+    workers.reserve(numChunks - 1);
+    for (size_t i = 1; i < numChunks; i++) {
+        workers.emplace_back(parseChunk, limites[i], limites[i + 1], ref(chunks[i]));
+    }
+    parseChunk(limites[0], limites[1], chunks[0]);
+    for (auto& worker : workers) { worker.join(); }
+
+    // Junta os vértices dos blocos na ordem do arquivo (mantém a numeração global dos índices)
+    if (numChunks == 1) {
+        vertices  = move(chunks[0].vertices);
+        texCoords = move(chunks[0].texCoords);
+        normals   = move(chunks[0].normals);
+    } else {
+        for (auto& chunk : chunks) {
+            vertices.insert (vertices.end(),  chunk.vertices.begin(),  chunk.vertices.end());
+            texCoords.insert(texCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+            normals.insert  (normals.end(),   chunk.normals.begin(),   chunk.normals.end());
+        }
+    }
+
+    // Reaplica os comandos de grupo/material na ordem do arquivo, distribuindo as faces de cada bloco
     Group* currentGroup = nullptr;  // Ponteiro para o grupo em processamento
     string currentMaterialName = ""; // Nome do material atual
 
     string objDirectory = getDirectory(objFilePath); // Obtém o diretório do arquivo .obj para localizar arquivos MTL e texturas
 
-    while (getline(objFile, objFileLine)) { // Lê o arquivo linha por linha e armazena cada linha em 'objFileLine'
-        
-        objFileLine = trim(objFileLine);  // Remove espaços em branco no início e no final da linha
-
-        if (objFileLine.empty() || objFileLine[0] == '#') { continue; } // Ignora linhas vazias e de comentários "#"
+    for (auto& chunk : chunks) {
 
-        istringstream sline(objFileLine); // Cria um stream de string para processar a linha
-        string prefix;
-        sline >> prefix;  // Lê o prefixo da linha (v, vt, vn, f, etc.)
+        size_t faceAtual = 0;   // próxima face do bloco ainda não adicionada a um grupo
 
-        if (prefix == "mtllib") { // Carrega o arquivo MTL para preencher o mapa de materiais
-            string mtlFilePath;
-            sline >> mtlFilePath;
-            //string mtlFilePath = objDirectory + "/" + mtlFileName;
-            readFileMTL(mtlFilePath, materials); // le o arquivo MTL e preenche o mapa de materiais
-        }
-        else if (prefix == "v") {           // adiciona as coord. do vértice (vec3), presentes na linha, ao vetor de
-            parseVertice(objFileLine, vertices);   // coordenadas dos vértices definido na classe Mesh (vector<vec3> vertices;)
-        }
-        else if (prefix == "vt") {          // adiciona as coord. de textura (vec2), presentes na linha, ao vetor de
-            parseTexCoord(objFileLine, texCoords); // coordenadas de textura definido na classe Mesh (vector<vec2> texCoords);
-        }
-        else if (prefix == "vn") {          // adiciona as normais (vec3), presentes na linha, ao vetor de    
-            parseNormal(objFileLine, normals);     // normais definido na classe Mesh (vector<vec3> normals);
-        }
-        else if (prefix == "g" || prefix == "o") {  // Verifica o nome do grupo e inicia um novo grupo
-            string groupName;
-            sline >> groupName;
-            if (groupName.empty()) groupName = "default";
-            groups.emplace_back(groupName); // adiciona o grupo em processamento ao vetor de grupos
-            currentGroup = &groups.back();  // ponteiro para o último elemento do vetor de groups (grupo atual)
-            
-            // Atribui o material atual ao grupo (se houver)
-            if (!currentMaterialName.empty() && materials.find(currentMaterialName) != materials.end()) {
-                currentGroup->material = materials[currentMaterialName];
+        // Move as faces [faceAtual, ate) do bloco para o grupo atual
+        auto moverFaces = [&](size_t ate) {
+            if (currentGroup && ate > faceAtual) {
+                currentGroup->faces.insert(currentGroup->faces.end(),
+                                           make_move_iterator(chunk.faces.begin() + faceAtual),
+                                           make_move_iterator(chunk.faces.begin() + ate));
             }
-        }
-        else if (prefix == "usemtl") { // Define o material atual
-            sline >> currentMaterialName;
-            
-            // Se já existe um grupo, atribui o material a ele
-            if (currentGroup && materials.find(currentMaterialName) != materials.end()) {
-                currentGroup->material = materials[currentMaterialName];
+            faceAtual = ate;
+        };
+
+        for (auto& comando : chunk.comandos) {
+
+            moverFaces(comando.faceIndex);
+
+            if (comando.tipo == OBJChunk::FACE_SEM_GRUPO) {
+                if (!currentGroup) {
+                    groups.emplace_back("default"); // adiciona o grupo em processamento ao vetor de grupos
+                    currentGroup = &groups.back();  // ponteiro para o último elemento do vetor de groups (grupo atual)
+                    
+                    // Atribui o material atual ao grupo (se houver)
+                    if (!currentMaterialName.empty() && materials.find(currentMaterialName) != materials.end()) {
+                        currentGroup->material = materials[currentMaterialName];
+                    }
+                }
             }
-        }
-        else if (prefix == "f") {   // Adiciona os indices que referenciam os vértices de uma face ao grupo atual.
-                                    // No arquivo .obj cada vertice é representado por índices no formato:
-                                    // vertice/texCoord/normal -> ex.: f 1/1/1 2/2/1 3/3/1 4/4/1
-            if (!currentGroup) {
-                groups.emplace_back("default"); // adiciona o grupo em processamento ao vetor de grupos
+            else if (comando.tipo == OBJChunk::MTLLIB) { // Carrega o arquivo MTL para preencher o mapa de materiais
+                //string mtlFilePath = objDirectory + "/" + mtlFileName;
+                readFileMTL(comando.nome, materials); // le o arquivo MTL e preenche o mapa de materiais
+                if (materialFiles) { materialFiles->push_back(comando.nome); }
+            }
+            else if (comando.tipo == OBJChunk::GRUPO) {  // Verifica o nome do grupo e inicia um novo grupo
+                string groupName = comando.nome.empty() ? "default" : comando.nome;
+                groups.emplace_back(groupName); // adiciona o grupo em processamento ao vetor de grupos
                 currentGroup = &groups.back();  // ponteiro para o último elemento do vetor de groups (grupo atual)
                 
                 // Atribui o material atual ao grupo (se houver)
@@ -92,14 +236,25 @@ bool OBJReader::readFileOBJ(const string& objFilePath,
                     currentGroup->material = materials[currentMaterialName];
                 }
             }
-            
-            Face face;  // gera/instancia uma nova face
-            parseFace(objFileLine, face);  // popula a face com os INDICES lidos na linha
-            currentGroup->addFace(face);   // adiciona a face processada ao grupo atual, que já está no vetor de grupos
+            else if (comando.tipo == OBJChunk::MATERIAL) { // Define o material atual
+                if (!comando.nome.empty()) { currentMaterialName = comando.nome; }
+                
+                // Se já existe um grupo, atribui o material a ele
+                if (currentGroup && materials.find(currentMaterialName) != materials.end()) {
+                    currentGroup->material = materials[currentMaterialName];
+                }
+            }
         }
+
+        moverFaces(chunk.faces.size());    // faces restantes do bloco vão para o grupo atual
     }
 
-    objFile.close();    // Fecha o arquivo .obj
+    objFile.close();    // Desfaz o mapeamento do arquivo .obj
+
+    double tempoMs = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+    cout << "Arquivo OBJ " << objFilePath << " lido em " << tempoMs << " ms ("
+         << vertices.size() << " vertices, " << groups.size() << " grupos, "
+         << numChunks << (numChunks == 1 ? " thread)" : " threads)") << endl;
 
     return true;
 }
@@ -107,6 +262,7 @@ bool OBJReader::readFileOBJ(const string& objFilePath,
 
 // Realiza a Leitura de um arquivo MTL e preenche o mapa de materiais
 bool OBJReader::readFileMTL(const string& mtlFilePath, map<string, Material>& materials) {
+    PROFILE_ZONE_DETAIL("OBJReader::readFileMTL", mtlFilePath);
     
     ifstream mtlFile(mtlFilePath); // Abre o arquivo MTL para leitura
     
@@ -173,74 +329,78 @@ bool OBJReader::readFileMTL(const string& mtlFilePath, map<string, Material>& ma
 
 // Analisa uma linha do arquivo OBJ e preenche os indices da face
 // nos vetores de índices da face (vertexIndices, textureIndices, normalIndices)
-void OBJReader::parseFace(const string& faceStr, Face& face) {
-    
-    istringstream sline(faceStr); // Cria um stream de string para processar a linha
-
-    string indicesStr;  // string temporária para processamento
+// Cada sequência de índices tem o formato v, v/vt, v//vn ou v/vt/vn
+void OBJReader::parseFace(const char* line, const char* end, Face& face) {
 
-    sline >> indicesStr; // ignora o caracter "f"
+    face.vertexIndices.clear();     // limpa os índices da face anterior, mantendo a memória já reservada
+    face.textureIndices.clear();
+    face.normalIndices.clear();
 
-    while (sline >> indicesStr) {  // para cada sequencia de indices presentes na linha:
+    const char* p = skipBlanks(line, end);
 
-        vector<string> indices = split(indicesStr, '/');       // retira o caracter "/"
+    while (p < end) {  // para cada sequencia de indices presentes na linha:
 
-        if (!indices.empty() && !indices[0].empty()) {         // Adiciona o índice que referencia as coordenadas do vértice (vec3)
-            face.vertexIndices.push_back(stoi(indices[0]));    // presentes no vetor de vértices definido na classe Mesh
-        }                                                      // (vector<vec3> vertices;)
+        const char* tokenEnd = skipToken(p, end);
+        
+        // percorre os campos separados por "/" (0 = vértice, 1 = textura, 2 = normal)
+        for (int campo = 0; campo < 3 && p <= tokenEnd; campo++) {
+            const char* campoEnd = (const char*)memchr(p, '/', tokenEnd - p);
+            if (!campoEnd) { campoEnd = tokenEnd; }
+
+            int index;
+            if (campoEnd > p && from_chars(p + (*p == '+'), campoEnd, index).ec == errc()) {
+                if      (campo == 0) { face.vertexIndices.push_back(index);  }  // índice das coordenadas do vértice (vec3)
+                else if (campo == 1) { face.textureIndices.push_back(index); }  // índice das coordenadas de textura (vec2)
+                else                 { face.normalIndices.push_back(index);  }  // índice das coordenadas da normal (vec3)
+            }
 
-        if (indices.size() > 1 && !indices[1].empty()) {       // Adiciona o índice que referencia as coordenadas de textura (vec2)
-            face.textureIndices.push_back(stoi(indices[1]));   // presentes no vetor de coordenadas de textura definido na classe Mesh
-        }                                                      // (vector<vec2> texCoords;)
+            p = campoEnd + 1;   // pula o "/"
+        }
 
-        if (indices.size() > 2 && !indices[2].empty()) {       // Adiciona o índice que referencia as coordenadas da normal (vec3)
-            face.normalIndices.push_back(stoi(indices[2]));    // presentes no vetor de normais definido na classe Mesh
-        }                                                      // (vector<vec3> normals;)
+        p = skipBlanks(tokenEnd, end);
     }
 }
 
 
-void OBJReader::parseVertice(const string& line, vector<vec3>& vertices) {
+void OBJReader::parseVertice(const char* line, const char* end, vector<vec3>& vertices) {
     
-    istringstream sline(line);
-    string prefix;
     float x, y, z;
-    sline >> prefix >> x >> y >> z;
+    line = parseFloat(line, end, x);
+    line = parseFloat(line, end, y);
+    parseFloat(line, end, z);
     vertices.emplace_back(x, y, z);
 }
 
 
-void OBJReader::parseTexCoord(const string& line, vector<vec2>& texCoords) {
+void OBJReader::parseTexCoord(const char* line, const char* end, vector<vec2>& texCoords) {
 
-    istringstream sline(line);
-    string prefix;
     float u, v;
-    sline >> prefix >> u >> v;
+    line = parseFloat(line, end, u);
+    parseFloat(line, end, v);
     texCoords.emplace_back(u, v);
 }
 
 
-void OBJReader::parseNormal(const string& line, vector<vec3>& normals) {
+void OBJReader::parseNormal(const char* line, const char* end, vector<vec3>& normals) {
 
-    istringstream sline(line);
-    string prefix;
     float x, y, z;
-    sline >> prefix >> x >> y >> z;
+    line = parseFloat(line, end, x);
+    line = parseFloat(line, end, y);
+    parseFloat(line, end, z);
     normals.emplace_back(x, y, z);
 }
 
 
-vector<string> OBJReader::split(const string& str, char delimiter) {
+// Converte o próximo número real do intervalo com from_chars (sem locale e sem alocações)
+const char* OBJReader::parseFloat(const char* p, const char* end, float& value) {
 
-    vector<string> tokens;
-    string token;
-    istringstream tokenStream(str);
+    value = 0.0f;
+    p = skipBlanks(p, end);
+    if (p < end && *p == '+') { ++p; }  // from_chars não aceita o sinal "+"
 
-    while (getline(tokenStream, token, delimiter)) {
-        tokens.push_back(token);
-    }
+    from_chars_result resultado = from_chars(p, end, value);
     
-    return tokens;
+    return (resultado.ec == errc()) ? resultado.ptr : skipToken(p, end);
 }
 
 
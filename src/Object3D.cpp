@@ -1,4 +1,5 @@
 #include "Object3D.h"
+#include "ModelRegistry.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -6,10 +7,15 @@
 
 Object3D::Object3D() 
 	: transform(1.0f), 
+	  invTransform(1.0f),
 	  position (0.0f), 
 	  rotation (0.0f), 
 	  scale    (1.0f), 
+	  previousPosition(0.0f),
+	  previousRotation(0.0f),
 	  eliminable(true), 
+	  collidable(true),
+	  broadPhaseProxy(-1),
 	  name(""),
 	  currentCurveIndex(0),
 	  curveTimer(0.0f),
@@ -22,10 +28,15 @@ Object3D::Object3D()
 
 Object3D::Object3D(string& objName)
 	: transform(1.0f),  // matriz identidade
+	  invTransform(1.0f),
 	  position (0.0f),  // posição zero
 	  rotation (0.0f),  // sem rotação
 	  scale    (1.0f),  // escala unitária
+	  previousPosition(0.0f),
+	  previousRotation(0.0f),
 	  eliminable(true),
+	  collidable(true),
+	  broadPhaseProxy(-1),
 	  name(objName),
 	  currentCurveIndex(0),
 	  curveTimer(0.0f),
@@ -36,14 +47,15 @@ Object3D::Object3D(string& objName)
 	//  hasTexture(false)
 	{ updateTransform(); }
 
-Object3D::~Object3D() { mesh.cleanup(); }
+Object3D::~Object3D() {}  // a malha é liberada quando o último objeto e o ModelRegistry a soltam
 
 
 // Carrega um objeto 3D a partir de um arquivo
-// uso: System::loadSceneObjects -> Object3D::loadObject -> Mesh::readObjectModel -> OBJReader::readFileOBJ
+// uso: System::loadSceneObjects -> Object3D::loadObject -> ModelRegistry::load -> Mesh::readObjectModel -> OBJReader::readFileOBJ
 bool Object3D::loadObject(string& path) {
 
-	if (!mesh.readObjectModel(path)) {
+	mesh = ModelRegistry::load(path);	// modelos repetidos na cena reaproveitam a malha já carregada
+	if (!mesh) {
 		cerr << "Falha ao carregar arquivo OBJ: " << path << endl;
 		return false;
 	}
@@ -53,15 +65,29 @@ bool Object3D::loadObject(string& path) {
 }
 
 
-// Renderiza o objeto 3D usando o shader fornecido
-void Object3D::render(const Shader& shader) const {
-	glUniformMatrix4fv(glGetUniformLocation(shader.ID, "model"), 1, GL_FALSE, value_ptr(transform));
-    
-	// Set default object color
-	glUniform3f(glGetUniformLocation(shader.ID, "objectColor"), 0.7f, 0.7f, 0.7f); // cinza claro
-    
-	// A textura agora é gerenciada pelos grupos através dos materiais MTL
-	mesh.render(shader);
+void Object3D::beginStep() {
+	previousPosition = position;
+	previousRotation = rotation;
+}
+
+
+// Objetos parados usam a matriz já calculada; os animados interpolam posição e rotação do passo anterior ao atual
+mat4 Object3D::interpolatedTransform(float alpha) const {
+	if (!isAnimated || alpha >= 1.0f) return transform;
+	return interpolateTransform(previousPosition, position, previousRotation, rotation, scale, alpha);
+}
+
+
+// A diferença de cada ângulo é levada para [-pi, pi] para não girar pelo lado mais longo
+mat4 Object3D::interpolateTransform(const vec3& prevPos, const vec3& pos, const vec3& prevRot, const vec3& rot,
+                                    const vec3& scl, float alpha) {
+	const float PI = 3.14159265358979f;
+	vec3 deltaRotation = rot - prevRot;
+	for (int i = 0; i < 3; i++) {
+		deltaRotation[i] = deltaRotation[i] - 2.0f * PI * floor((deltaRotation[i] + PI) / (2.0f * PI));
+	}
+
+	return composeTransform(mix(prevPos, pos, alpha), prevRot + deltaRotation * alpha, scl);
 }
 
 
@@ -91,12 +117,21 @@ void Object3D::setEliminable(bool canEliminate) {
 // Atualiza a matriz de transformação (matrix "model" no pipeline gráfico) com base na posição, rotação e escala
 void Object3D::updateTransform() {
 
-	transform = mat4(1.0f); // "zera" a matriz de transformação
+	transform = composeTransform(position, rotation, scale);
+
+	invTransform = inverse(transform);  // usada pelo rayIntersect de cada projétil candidato
+}
+
+
+// Monta a matriz de modelo (usada por updateTransform e pela interpolação entre passos de simulação)
+mat4 Object3D::composeTransform(const vec3& pos, const vec3& rot, const vec3& scl) {
+
+	mat4 transform = mat4(1.0f); // "zera" a matriz de transformação
 
 	// Aplica transformações na ordem: Escala -> Rotação -> Translação
 
 	// translação
-	transform = translate(transform, position);
+	transform = translate(transform, pos);
     
 	// Aplica rotações
 	// Ordem alterada para: Yaw -> Pitch ->  Roll
@@ -105,13 +140,14 @@ void Object3D::updateTransform() {
 	// Isso resolveu problemas de inversão da inclinação, à esquerda ou a direita da pista.
 	// fontes: https://learnopengl.com/Getting-started/Transformations (Matrix multiplication order)
 	// 		   https://learnopengl.com/Getting-started/Camera (Euler Angles)
-	transform = rotate(transform, rotation.y, vec3(0.0f, 1.0f, 0.0f));	// Yaw   (Ry)
-	transform = rotate(transform, rotation.x, vec3(1.0f, 0.0f, 0.0f));	// Pitch (Rx)
-	transform = rotate(transform, rotation.z, vec3(0.0f, 0.0f, 1.0f));	// Roll  (Rz)
+	transform = rotate(transform, rot.y, vec3(0.0f, 1.0f, 0.0f));	// Yaw   (Ry)
+	transform = rotate(transform, rot.x, vec3(1.0f, 0.0f, 0.0f));	// Pitch (Rx)
+	transform = rotate(transform, rot.z, vec3(0.0f, 0.0f, 1.0f));	// Roll  (Rz)
     
 	// Matematicamente ficou: transform = Rz * Rx * Ry * T
 
-	transform = glm::scale(transform, scale); // aplica escala
+	transform = glm::scale(transform, scl); // aplica escala
+	return transform;
 }
 
 
@@ -121,7 +157,7 @@ BoundingBox Object3D::getTransformedBoundingBox() const {
 
 	// Obtém os 8 cantos da bounding box original
 	vec3 corners[8];
-	mesh.boundingBox.getCorners(corners);
+	mesh->boundingBox.getCorners(corners);
     
 	// Transforma todos os 8 cantos pela matriz de transformação
 	for (int i = 0; i < 8; i++) {
@@ -133,20 +169,25 @@ BoundingBox Object3D::getTransformedBoundingBox() const {
 }
 
 
-// Testa interseção do raio com a bounding box (retorna true se houver interseção)
-// Se houver interseção, retorna a distância até o ponto de interseção mais próximo
+// Testa o raio contra os triângulos da malha (BVH em espaço do objeto) e retorna o triângulo mais próximo
 // objetos muito rápidos podem atravessar objetos sem detectar colisão !!!
-bool Object3D::rayIntersect(const vec3& rayOrigin, const vec3& rayDirection, float& distance) const {
-	// Transforma as informações do "raio" para o espaço do objeto ("Local Space")
-	mat4 invTransform = inverse(transform);   // gera a matriz inversa da transformação
+bool Object3D::rayIntersect(const vec3& rayOrigin, const vec3& rayDirection, float maxDistance, RayHit& hit) const {
+	// Transforma as informações do "raio" para o espaço do objeto ("Local Space") com a inversa já calculada
 	vec4 localOrigin = invTransform * vec4(rayOrigin, 1.0f); // ponto de origem do raio no espaço do objeto
 	vec4 localDirection = invTransform * vec4(rayDirection, 0.0f); // direção do raio no espaço do objeto
     
-	// verifica interseção com a bounding box da malha no espaço do objeto
-	return mesh.rayIntersect(vec3(localOrigin), normalize(vec3(localDirection)), distance);
+	// a direção local não é normalizada: assim o parâmetro do raio (distância) continua em unidades de mundo
+	// mesmo em objetos escalados, e pode ser comparado com o deslocamento do projétil no quadro
+	if (!mesh->rayIntersect(vec3(localOrigin), vec3(localDirection), maxDistance, hit)) return false;
+
+	// Normal de volta para o mundo (transposta da inversa) e voltada contra o raio
+	hit.normal = normalize(transpose(mat3(invTransform)) * hit.normal);
+	if (dot(hit.normal, rayDirection) > 0.0f) { hit.normal = -hit.normal; }
+	return true;
 }
 
 
+
 // Carrega os pontos da curva de animação a partir de um arquivo
 // Aplica as transformações da pista (posição, rotação, escala) aos pontos da curva
 bool Object3D::loadAnimationCurve(const string& curveFilePath,
@@ -0,0 +1,265 @@
+#include "Profiler.h"
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+
+const chrono::steady_clock::time_point Profiler::epoch = chrono::steady_clock::now();
+
+namespace {
+
+struct Evento {
+    const char* nome;
+    uint32_t detalhe;
+    uint64_t inicioNs;
+    uint64_t duracaoNs;
+};
+
+// Buffer circular de uma thread: só a thread dona escreve; "gravados" conta todas as zonas já gravadas
+// (a zona i fica na posição i % RING_EVENTS) e é publicado depois da escrita da zona
+struct BufferThread {
+    uint32_t id;
+    string nome;
+    vector<Evento> eventos;
+    atomic<uint64_t> gravados;
+
+    BufferThread(uint32_t id) : id(id), eventos(Profiler::RING_EVENTS), gravados(0) {}
+};
+
+// Registro global: os buffers sobrevivem às suas threads, para que as zonas delas entrem no arquivo.
+// O buffer de uma thread que terminou volta para "livres" e é reaproveitado, vazio e sem nome, pela próxima
+// thread que gravar (os JobSystem recriados a cada benchmark não acumulam buffers nem faixas repetidas no arquivo)
+mutex registroLock;
+vector<unique_ptr<BufferThread>> buffers;
+vector<BufferThread*> livres;
+vector<string> textos;
+unordered_map<string, uint32_t> indiceTextos;
+
+// Buffer da thread atual; devolvido ao registro quando a thread termina
+struct BufferLocal {
+    BufferThread* buffer = nullptr;
+
+    ~BufferLocal() {
+        if (!buffer) return;
+        lock_guard<mutex> trava(registroLock);
+        livres.push_back(buffer);
+    }
+};
+
+thread_local BufferLocal bufferLocal;
+
+BufferThread* bufferDaThread() {
+    if (!bufferLocal.buffer) {
+        lock_guard<mutex> trava(registroLock);
+        if (!livres.empty()) {
+            // As zonas da thread anterior são descartadas: não podem aparecer com o nome da nova thread.
+            // Sob registroLock, nenhuma cópia (copiarEventos) está lendo este buffer
+            bufferLocal.buffer = livres.back();
+            livres.pop_back();
+            bufferLocal.buffer->nome.clear();
+            bufferLocal.buffer->gravados.store(0, memory_order_relaxed);
+        } else {
+            buffers.emplace_back(new BufferThread((uint32_t)buffers.size() + 1));
+            bufferLocal.buffer = buffers.back().get();
+        }
+    }
+    return bufferLocal.buffer;
+}
+
+// Cópia consistente das zonas guardadas no buffer, em ordem de gravação
+vector<Evento> copiarEventos(const BufferThread& buffer) {
+    uint64_t fim = buffer.gravados.load(memory_order_acquire);
+    uint64_t inicio = fim > Profiler::RING_EVENTS ? fim - Profiler::RING_EVENTS : 0;
+
+    vector<Evento> copia;
+    copia.reserve((size_t)(fim - inicio));
+    for (uint64_t i = inicio; i < fim; i++) { copia.push_back(buffer.eventos[i % Profiler::RING_EVENTS]); }
+
+    // A thread dona pode ter sobrescrito as mais antigas enquanto a cópia era feita: ficam só as que não
+    // foram alcançadas (a posição da zona "agora" também pode estar em escrita). A barreira impede que a
+    // segunda leitura do contador seja antecipada para antes da cópia (como na leitura de um seqlock)
+    atomic_thread_fence(memory_order_acquire);
+    uint64_t agora = buffer.gravados.load(memory_order_relaxed);
+    if (agora + 1 > inicio + Profiler::RING_EVENTS) {
+        size_t descartadas = (size_t)std::min<uint64_t>(agora + 1 - Profiler::RING_EVENTS - inicio, copia.size());
+        copia.erase(copia.begin(), copia.begin() + descartadas);
+    }
+    return copia;
+}
+
+// Cópia do registro para a gravação do arquivo: feita sob registroLock, para que a escrita em disco não
+// bloqueie as threads que começam a gravar, dão nome à thread ou guardam textos
+struct CopiaThread {
+    uint32_t id;
+    string nome;
+    vector<Evento> eventos;
+};
+
+vector<CopiaThread> copiarRegistro(vector<string>& copiaTextos) {
+    lock_guard<mutex> trava(registroLock);
+    copiaTextos = textos;
+
+    vector<CopiaThread> copia;
+    copia.reserve(buffers.size());
+    for (const auto& buffer : buffers) {
+        copia.push_back({ buffer->id, buffer->nome.empty() ? "thread " + to_string(buffer->id) : buffer->nome,
+                          copiarEventos(*buffer) });
+    }
+    return copia;
+}
+
+
+// Texto escapado para JSON
+void escreverTexto(FILE* arquivo, const string& texto) {
+    fputc('"', arquivo);
+    for (char c : texto) {
+        if (c == '"' || c == '\\') { fputc('\\', arquivo); fputc(c, arquivo); }
+        else if ((unsigned char)c < 0x20) { fprintf(arquivo, "\\u%04x", (unsigned char)c); }
+        else { fputc(c, arquivo); }
+    }
+    fputc('"', arquivo);
+}
+
+}   // namespace
+
+
+bool Profiler::compiledIn() {
+#ifdef VISUALIZADOR_PROFILER
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+void Profiler::setThreadName(const string& name) {
+    BufferThread* buffer = bufferDaThread();
+    lock_guard<mutex> trava(registroLock);
+    buffer->nome = name;
+}
+
+
+uint32_t Profiler::intern(const string& detail) {
+    lock_guard<mutex> trava(registroLock);
+    auto it = indiceTextos.find(detail);
+    if (it != indiceTextos.end()) { return it->second; }
+
+    uint32_t indice = (uint32_t)textos.size();
+    textos.push_back(detail);
+    indiceTextos[detail] = indice;
+    return indice;
+}
+
+
+void Profiler::record(const char* name, uint32_t detail, uint64_t startNs, uint64_t endNs) {
+    BufferThread* buffer = bufferDaThread();
+    uint64_t i = buffer->gravados.load(memory_order_relaxed);
+    buffer->eventos[i % RING_EVENTS] = Evento{ name, detail, startNs, endNs - startNs };
+    buffer->gravados.store(i + 1, memory_order_release);
+}
+
+
+bool Profiler::write(const string& path) {
+    if (!compiledIn()) {
+        cerr << "Perfil de CPU indisponivel: compile com -DVISUALIZADOR_PROFILER" << endl;
+        return false;
+    }
+
+    bool binario = path.size() >= 4 && path.compare(path.size() - 4, 4, ".bin") == 0;
+    bool gravado = binario ? writeBinary(path) : writeChromeTrace(path);
+    if (gravado) { cout << "Perfil de CPU gravado em " << path << endl; }
+    return gravado;
+}
+
+
+// Eventos completos ("ph": "X") com início e duração em microssegundos (com frações: precisão de nanossegundos)
+bool Profiler::writeChromeTrace(const string& path) {
+    FILE* arquivo = fopen(path.c_str(), "w");
+    if (!arquivo) {
+        cerr << "Falha ao criar arquivo do perfil: " << path << endl;
+        return false;
+    }
+
+    vector<string> copiaTextos;
+    vector<CopiaThread> threads = copiarRegistro(copiaTextos);
+    fprintf(arquivo, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+
+    bool primeiro = true;
+    for (const CopiaThread& thread : threads) {
+        fprintf(arquivo, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": ",
+                primeiro ? "" : ",\n", thread.id);
+        escreverTexto(arquivo, thread.nome);
+        fprintf(arquivo, "}}");
+        primeiro = false;
+
+        for (const Evento& evento : thread.eventos) {
+            fprintf(arquivo, ",\n{\"name\": ");
+            escreverTexto(arquivo, evento.nome);
+            fprintf(arquivo, ", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f",
+                    thread.id, evento.inicioNs / 1000.0, evento.duracaoNs / 1000.0);
+            if (evento.detalhe != NO_DETAIL && evento.detalhe < copiaTextos.size()) {
+                fprintf(arquivo, ", \"args\": {\"detail\": ");
+                escreverTexto(arquivo, copiaTextos[evento.detalhe]);
+                fprintf(arquivo, "}");
+            }
+            fprintf(arquivo, "}");
+        }
+    }
+    fprintf(arquivo, "\n]}\n");
+
+    bool gravado = ferror(arquivo) == 0;
+    fclose(arquivo);
+    return gravado;
+}
+
+
+// Formato descrito em Profiler.h: os nomes das zonas entram na mesma tabela de textos dos detalhes
+bool Profiler::writeBinary(const string& path) {
+    ofstream arquivo(path, ios::binary);
+    if (!arquivo.is_open()) {
+        cerr << "Falha ao criar arquivo do perfil: " << path << endl;
+        return false;
+    }
+
+    vector<string> tabela;     // detalhes mantêm os seus índices; nomes vêm depois
+    vector<CopiaThread> threads = copiarRegistro(tabela);
+    unordered_map<const char*, uint32_t> indiceNomes;
+    vector<uint32_t> nomesThreads;
+    for (const CopiaThread& thread : threads) {
+        for (const Evento& evento : thread.eventos) {
+            if (indiceNomes.emplace(evento.nome, (uint32_t)tabela.size()).second) { tabela.push_back(evento.nome); }
+        }
+        nomesThreads.push_back((uint32_t)tabela.size());
+        tabela.push_back(thread.nome);
+    }
+
+    auto escrever32 = [&](uint32_t valor) { arquivo.write((const char*)&valor, sizeof(valor)); };
+    auto escrever64 = [&](uint64_t valor) { arquivo.write((const char*)&valor, sizeof(valor)); };
+
+    arquivo.write("VPRF", 4);
+    escrever32(1);
+    escrever32((uint32_t)tabela.size());
+    for (const string& texto : tabela) {
+        escrever32((uint32_t)texto.size());
+        arquivo.write(texto.data(), texto.size());
+    }
+
+    escrever32((uint32_t)threads.size());
+    for (size_t t = 0; t < threads.size(); t++) {
+        escrever32(threads[t].id);
+        escrever32(nomesThreads[t]);
+        escrever64(threads[t].eventos.size());
+        for (const Evento& evento : threads[t].eventos) {
+            escrever32(indiceNomes[evento.nome]);
+            escrever32(evento.detalhe);
+            escrever64(evento.inicioNs);
+            escrever64(evento.duracaoNs);
+        }
+    }
+    return arquivo.good();
+}
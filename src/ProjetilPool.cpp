@@ -0,0 +1,143 @@
+#include "ProjetilPool.h"
+#include "JobSystem.h"
+#include <chrono>
+
+
+ProjetilPool::ProjetilPool(size_t capacity)
+    : posX(capacity), posY(capacity), posZ(capacity),
+      prevX(capacity), prevY(capacity), prevZ(capacity),
+      dirX(capacity), dirY(capacity), dirZ(capacity),
+      speed(capacity), lifetime(capacity), maxLifetime(capacity), alive(capacity, 0),
+      lastUpdateMicros(0.0), used(0), live(0) {
+    freeSlots.reserve(capacity);
+}
+
+
+long ProjetilPool::spawn(const vec3& startPos, const vec3& dir, float projetilSpeed, float maxLife) {
+
+    size_t slot;
+    if (!freeSlots.empty()) {       // reaproveita um slot liberado
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        if (slot >= used) { used = slot + 1; }  // slot acima do limite recolhido (ver update)
+    } else if (used < capacity()) { // ou ocupa o próximo slot ainda não utilizado
+        slot = used++;
+    } else {
+        return -1;                  // conjunto cheio
+    }
+
+    vec3 direcao = normalize(dir);
+    posX[slot] = startPos.x;  posY[slot] = startPos.y;  posZ[slot] = startPos.z;
+    prevX[slot] = startPos.x; prevY[slot] = startPos.y; prevZ[slot] = startPos.z;
+    dirX[slot] = direcao.x;   dirY[slot] = direcao.y;   dirZ[slot] = direcao.z;
+    speed[slot] = projetilSpeed;
+    lifetime[slot] = 0.0f;
+    maxLifetime[slot] = maxLife;
+    alive[slot] = ACTIVE;
+    live++;
+
+    return (long)slot;
+}
+
+
+void ProjetilPool::release(size_t slot) {
+    if (!alive[slot]) return;
+    alive[slot] = FREE;
+    freeSlots.push_back((uint32_t)slot);
+    live--;
+}
+
+
+void ProjetilPool::update(float deltaTime, JobSystem* jobs) {
+
+    auto inicio = chrono::steady_clock::now();
+
+    const size_t n = used;
+    if (jobs) {
+        jobs->parallelFor(0, n, UPDATE_GRAIN, [this, deltaTime](size_t b, size_t e) { integrate(b, e, deltaTime); });
+    } else {
+        integrate(0, n, deltaTime);
+    }
+
+    lastUpdateMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - inicio).count();
+}
+
+
+// Recolhe os slots que expiraram neste passo para a lista de livres
+void ProjetilPool::releaseExpired() {
+    uint8_t* __restrict vivo = alive.data();
+    for (size_t i = 0; i < used; i++) {
+        if (vivo[i] == EXPIRING) {
+            vivo[i] = FREE;
+            freeSlots.push_back((uint32_t)i);
+            live--;
+        }
+    }
+
+    if (live == 0) { clear(); }     // conjunto vazio: os laços voltam a começar do zero
+
+    // Recolhe o limite dos laços até o último slot ocupado (os slots acima continuam na lista de livres)
+    while (used > 0 && !vivo[used - 1]) { used--; }
+}
+
+
+// Cada bloco escreve só nos seus slots: blocos diferentes podem ser integrados em threads diferentes
+void ProjetilPool::integrate(size_t begin, size_t end, float deltaTime) {
+    float* __restrict px = posX.data();
+    float* __restrict py = posY.data();
+    float* __restrict pz = posZ.data();
+    float* __restrict qx = prevX.data();
+    float* __restrict qy = prevY.data();
+    float* __restrict qz = prevZ.data();
+    const float* __restrict dx = dirX.data();
+    const float* __restrict dy = dirY.data();
+    const float* __restrict dz = dirZ.data();
+    const float* __restrict sp = speed.data();
+    float* __restrict lt = lifetime.data();
+    const float* __restrict ml = maxLifetime.data();
+    uint8_t* __restrict vivo = alive.data();
+
+    // Laço principal: sem desvios, os slots livres são "atualizados" com passo zero
+    // (no início do passo não há slots EXPIRING: vivo[i] é FREE ou ACTIVE, 0 ou 1)
+    for (size_t i = begin; i < end; i++) {
+        float passo = sp[i] * deltaTime * (float)vivo[i];
+        qx[i] = px[i];
+        qy[i] = py[i];
+        qz[i] = pz[i];
+        px[i] += dx[i] * passo;
+        py[i] += dy[i] * passo;
+        pz[i] += dz[i] * passo;
+        lt[i] += deltaTime;
+        // Projétil que atingiu o chão (Y <= 0) ou o tempo máximo passa a EXPIRING (1 << 1); os demais não mudam
+        uint8_t continua = (uint8_t)((lt[i] < ml[i]) & (py[i] > 0.0f));
+        vivo[i] = (uint8_t)(vivo[i] << (1 - continua));
+    }
+}
+
+
+void ProjetilPool::gatherPositions(vector<vec3>& previous, vector<vec3>& current) const {
+    previous.clear();
+    current.clear();
+    for (size_t i = 0; i < used; i++) {
+        if (alive[i]) {
+            previous.push_back(vec3(prevX[i], prevY[i], prevZ[i]));
+            current.push_back(vec3(posX[i], posY[i], posZ[i]));
+        }
+    }
+}
+
+
+void ProjetilPool::reflect(size_t slot, const vec3& normal) {
+    // calcula a direção do vetor de reflexão
+    vec3 direcao = direction(slot);
+    direcao = normalize(direcao - 2.0f * dot(direcao, normal) * normal);
+    dirX[slot] = direcao.x;  dirY[slot] = direcao.y;  dirZ[slot] = direcao.z;
+}
+
+
+void ProjetilPool::clear() {
+    for (size_t i = 0; i < used; i++) { alive[i] = FREE; }
+    freeSlots.clear();
+    used = 0;
+    live = 0;
+}
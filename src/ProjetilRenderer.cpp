@@ -1,58 +1,15 @@
-#include "Projetil.h"
+#include "ProjetilRenderer.h"
+#include "RenderStats.h"
 #include <glad/glad.h>
-#include <iostream>
 
 
-Projetil::Projetil() 
-    : position(0.0f), direction(0.0f, 0.0f, 1.0f), speed(10.0f), 
-      lifetime(0.0f), maxLifetime(5.0f), active(false), VAO(0), VBO(0) {
-    setupMesh();
-}
-
-Projetil::Projetil(const vec3& startPos, const vec3& dir, float projetilSpeed, float maxLife)
-    : position(startPos), direction(normalize(dir)), speed(projetilSpeed),
-      lifetime(0.0f), maxLifetime(maxLife), active(true), VAO(0), VBO(0) {
-    setupMesh();
-}
+ProjetilRenderer::ProjetilRenderer() : VAO(0), VBO(0), instanceVBO(0), instanceCapacity(0) {}
 
-Projetil::~Projetil() {
-    cleanup();  // libera recursos da OpenGL
-}
 
-void Projetil::update(float deltaTime) {
-    if (!active) return;
-    // Atualiza a posição do projétil e verifica se deve ser desativado
-    position += direction * speed * deltaTime;
-    lifetime += deltaTime;
-    
-    // Desativa projétil se atingir o chão (Y <= 0) ou tempo máximo
-    if (lifetime >= maxLifetime || position.y <= 0.0f) {
-        active = false;
-    }
-}
+ProjetilRenderer::~ProjetilRenderer() { cleanup(); }
 
-void Projetil::draw(const Shader& shader) const {
-    if (!active || VAO == 0) return;
-    
-    mat4 model = mat4(1.0f);
-    model = translate(model, position);
-    model = scale(model, vec3(0.05f)); // projétil pequeno - ajuste conforme necessário
-    
-    glUniformMatrix4fv(glGetUniformLocation(shader.ID, "model"), 1, GL_FALSE, value_ptr(model));
-    glUniform3f(glGetUniformLocation(shader.ID, "objectColor"), 1.0f, 1.0f, 0.0f); // Projétil amarelo
-
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, 36); // Cubo tem 36 vértices
-    glBindVertexArray(0);
-}
-
-void Projetil::reflect(const vec3& normal) {
-    // calcula a direção do vetor de reflexão
-    direction = direction - 2.0f * dot(direction, normal) * normal;
-    direction = normalize(direction);
-}
 
-void Projetil::setupMesh() {
+void ProjetilRenderer::setup() {
     // Para visualização de projétil, usamos um cubo simples - 36 vértices
     float vertices[] = {
         // positions
@@ -98,9 +55,12 @@ void Projetil::setupMesh() {
         -0.5f,  0.5f,  0.5f,
         -0.5f,  0.5f, -0.5f
     };
+
+    cleanup();
     
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
+    glGenBuffers(1, &instanceVBO);
     
     glBindVertexArray(VAO);
     
@@ -109,12 +69,43 @@ void Projetil::setupMesh() {
     
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
+
+    // Atributo por instância: posição (xyz) e escala (w) do projétil - location 7
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(vec4), (void*)0);
+    glEnableVertexAttribArray(7);
+    glVertexAttribDivisor(7, 1);    // avança uma vez por instância, não por vértice
     
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 }
 
-void Projetil::cleanup() {    // libera recursos da OpenGL
+
+void ProjetilRenderer::draw(const Shader& shader, const vector<vec4>& instances) {
+    if (VAO == 0 || instances.empty()) return;
+
+    // Envia as instâncias do quadro (o buffer só é realocado quando precisa crescer)
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    if (instances.size() > instanceCapacity) {
+        instanceCapacity = instances.size() * 2;
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(vec4), nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(vec4), instances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    shader.setVec3(Shader::OBJECT_COLOR, vec3(1.0f, 1.0f, 0.0f)); // Projétil amarelo
+
+    glBindVertexArray(VAO);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, (GLsizei)instances.size()); // Cubo tem 36 vértices
+    glBindVertexArray(0);
+
+    RenderStats::stateChanges += 4;
+    RenderStats::uniformUploads++;
+    RenderStats::drawCalls++;
+}
+
+
+void ProjetilRenderer::cleanup() {    // libera recursos da OpenGL
     if (VAO != 0) {
         glDeleteVertexArrays(1, &VAO);
         VAO = 0;
@@ -123,4 +114,9 @@ void Projetil::cleanup() {    // libera recursos da OpenGL
         glDeleteBuffers(1, &VBO);
         VBO = 0;
     }
+    if (instanceVBO != 0) {
+        glDeleteBuffers(1, &instanceVBO);
+        instanceVBO = 0;
+    }
+    instanceCapacity = 0;
 }
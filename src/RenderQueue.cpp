@@ -0,0 +1,112 @@
+#include "RenderQueue.h"
+#include "Shader.h"
+#include "RenderStats.h"
+#include <glad/glad.h>
+#include <algorithm>
+
+
+RenderQueue::RenderQueue() : lastStats{0, 0, 0} {}
+
+
+void RenderQueue::clear() {
+    items.clear();  // mantém a capacidade: sem realocações de um quadro para o outro
+}
+
+
+void RenderQueue::submit(DrawItem item) {
+    item.key = makeKey(item);
+    items.push_back(item);
+}
+
+
+uint64_t RenderQueue::makeKey(const DrawItem& item) {
+    uint64_t program  = item.shader ? item.shader->ID & 0xFF : 0;
+    uint64_t texture  = item.texture & 0xFFFF;
+    uint64_t vao      = item.VAO & 0xFFFF;
+    uint64_t buffer   = item.materialBuffer ? item.materialBuffer->ID & 0xFFF : 0;
+    uint64_t material = (item.materialOffset / UniformBuffer::offsetAlignment()) & 0xFFF;
+    return (program << 56) | (texture << 40) | (vao << 24) | (buffer << 12) | material;
+}
+
+
+void RenderQueue::flush(const Shader* activeShader) {
+
+    lastStats = {0, 0, 0};
+
+    // Ordenação estável: itens com a mesma chave mantêm a ordem de envio (ordem da cena)
+    stable_sort(items.begin(), items.end(), [](const DrawItem& a, const DrawItem& b) { return a.key < b.key; });
+
+    // Estado atual da OpenGL, conhecido pela fila (começa "inválido" para forçar o primeiro envio)
+    const Shader* shaderAtual = nullptr;
+    bool primeiroItem = true;
+    unsigned int texturaAtual = ~0u;
+    unsigned int vaoAtual = ~0u;
+    unsigned int bufferAtual = ~0u;
+    size_t materialAtual = ~(size_t)0;
+    int hasDiffuseMapAtual = -1;
+    bool temCor = false;
+    vec3 corAtual;
+
+    for (const auto& item : items) {
+
+        if (item.shader != shaderAtual) {
+            if (primeiroItem && item.shader == activeShader) { lastStats.bindsSkipped++; }
+            else { glUseProgram(item.shader->ID); RenderStats::stateChanges++; }
+            item.shader->setInt(Shader::DIFFUSE_MAP, 0);   // unidade de textura fixa
+            shaderAtual = item.shader;
+            hasDiffuseMapAtual = -1;    // uniforms são do programa: reenviar após a troca
+            temCor = false;
+        } else { lastStats.bindsSkipped++; }
+        primeiroItem = false;
+
+        if (item.texture != texturaAtual) {
+            if (texturaAtual == ~0u) { glActiveTexture(GL_TEXTURE0); RenderStats::stateChanges++; }
+            glBindTexture(GL_TEXTURE_2D, item.texture);
+            RenderStats::stateChanges++;
+            texturaAtual = item.texture;
+        } else { lastStats.bindsSkipped++; }
+
+        int hasDiffuseMap = item.texture != 0;
+        if (hasDiffuseMap != hasDiffuseMapAtual) {
+            item.shader->setInt(Shader::HAS_DIFFUSE_MAP, hasDiffuseMap);
+            hasDiffuseMapAtual = hasDiffuseMap;
+        } else { lastStats.uniformsSkipped++; }
+
+        unsigned int bufferID = item.materialBuffer ? item.materialBuffer->ID : 0;
+        if (bufferID != bufferAtual || item.materialOffset != materialAtual) {
+            if (item.materialBuffer) {
+                item.materialBuffer->bindRange(MATERIAL_BINDING, item.materialOffset, sizeof(MaterialUniforms));
+            }
+            bufferAtual = bufferID;
+            materialAtual = item.materialOffset;
+        } else { lastStats.bindsSkipped++; }
+
+        if (item.VAO != vaoAtual) {
+            glBindVertexArray(item.VAO);
+            RenderStats::stateChanges++;
+            vaoAtual = item.VAO;
+        } else { lastStats.bindsSkipped++; }
+
+        if (!temCor || corAtual != item.objectColor) {
+            item.shader->setVec3(Shader::OBJECT_COLOR, item.objectColor);
+            corAtual = item.objectColor;
+            temCor = true;
+        } else { lastStats.uniformsSkipped++; }
+
+        size_t indexSize = (item.indexType == GL_UNSIGNED_SHORT) ? sizeof(unsigned short) : sizeof(unsigned int);
+        glDrawElementsInstanced(GL_TRIANGLES, item.indexCount, item.indexType,
+                                (void*)(item.firstIndex * indexSize), item.instanceCount);
+        RenderStats::drawCalls++;
+        lastStats.draws++;
+    }
+
+    // Desvincula o VAO e a textura uma única vez, ao final da fila
+    if (!items.empty()) {
+        glBindVertexArray(0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        RenderStats::stateChanges += 2;
+    }
+
+    RenderStats::bindsSkipped    += lastStats.bindsSkipped;
+    RenderStats::uniformsSkipped += lastStats.uniformsSkipped;
+}
@@ -0,0 +1,55 @@
+#include "RenderStats.h"
+#include <iostream>
+
+using namespace std;
+
+bool RenderStats::enabled = false;
+
+unsigned int RenderStats::uniformLookups = 0;
+unsigned int RenderStats::uniformUploads = 0;
+unsigned int RenderStats::stateChanges = 0;
+unsigned int RenderStats::drawCalls = 0;
+unsigned int RenderStats::bindsSkipped = 0;
+unsigned int RenderStats::uniformsSkipped = 0;
+
+unsigned long long RenderStats::totalLookups = 0;
+unsigned long long RenderStats::totalUploads = 0;
+unsigned long long RenderStats::totalStateChanges = 0;
+unsigned long long RenderStats::totalDrawCalls = 0;
+unsigned long long RenderStats::totalBindsSkipped = 0;
+unsigned long long RenderStats::totalUniformsSkipped = 0;
+unsigned int RenderStats::frames = 0;
+float RenderStats::lastReport = 0.0f;
+
+
+void RenderStats::endFrame(float currentTime, float interval) {
+
+    totalLookups      += uniformLookups;
+    totalUploads      += uniformUploads;
+    totalStateChanges += stateChanges;
+    totalDrawCalls    += drawCalls;
+    totalBindsSkipped    += bindsSkipped;
+    totalUniformsSkipped += uniformsSkipped;
+    frames++;
+
+    uniformLookups = uniformUploads = stateChanges = drawCalls = 0;
+    bindsSkipped = uniformsSkipped = 0;
+
+    if (currentTime - lastReport < interval) { return; }
+
+    if (enabled && frames > 0) {
+        unsigned long long total = totalLookups + totalUploads + totalStateChanges + totalDrawCalls;
+        cout << "Chamadas ao driver por quadro: " << total / frames
+             << " (glGetUniformLocation: " << totalLookups / frames
+             << ", uniforms: " << totalUploads / frames
+             << ", binds: " << totalStateChanges / frames
+             << ", desenhos: " << totalDrawCalls / frames
+             << ") - evitados: " << totalBindsSkipped / frames << " binds, "
+             << totalUniformsSkipped / frames << " uniforms" << endl;
+    }
+
+    totalLookups = totalUploads = totalStateChanges = totalDrawCalls = 0;
+    totalBindsSkipped = totalUniformsSkipped = 0;
+    frames = 0;
+    lastReport = currentTime;
+}
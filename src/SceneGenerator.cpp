@@ -0,0 +1,218 @@
+#include "SceneGenerator.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <cstdio>
+
+// Relevo suave da superfície (altura e normal em coordenadas de mundo), com fase definida pela semente
+// A forma é a mesma para qualquer tamanho: as ondas são definidas na coordenada normalizada (x / escala)
+struct Relevo {
+    float fase, amplitude, escala;
+
+    float altura(float x, float z) const {
+        return amplitude * sin(x / escala * 6.0f + fase) * cos(z / escala * 4.0f - fase);
+    }
+
+    // Normal a partir das derivadas da altura em x e z de mundo (regra da cadeia: 1 / escala)
+    void normal(float x, float z, float& nx, float& ny, float& nz) const {
+        float u = x / escala, w = z / escala;
+        float dx = amplitude * 6.0f * cos(u * 6.0f + fase) * cos(w * 4.0f - fase) / escala;
+        float dz = -amplitude * 4.0f * sin(u * 6.0f + fase) * sin(w * 4.0f - fase) / escala;
+        float comprimento = sqrt(dx * dx + 1.0f + dz * dz);
+        nx = -dx / comprimento;
+        ny = 1.0f / comprimento;
+        nz = -dz / comprimento;
+    }
+};
+
+
+// Canto de face no formato do OBJ: v, v/vt, v//vn ou v/vt/vn (índices a partir de 1)
+static void writeCorner(FILE* obj, size_t v, size_t vt, size_t vn, bool texCoords, bool normals) {
+    if (texCoords && normals) { fprintf(obj, " %zu/%zu/%zu", v, vt, vn); }
+    else if (texCoords)       { fprintf(obj, " %zu/%zu", v, vt); }
+    else if (normals)         { fprintf(obj, " %zu//%zu", v, vn); }
+    else                      { fprintf(obj, " %zu", v); }
+}
+
+
+bool SceneGenerator::writeOBJ(const string& objPath, const string& mtlPath, const OBJParams& params) {
+    int lados = std::max(params.arity, 3);
+    int grupos = std::max(params.groups, 1);
+    int materiais = std::max(params.materials, 1);
+
+    if (!writeMTL(mtlPath, materiais)) return false;
+
+    // stdio com buffer grande: modelos de milhões de vértices são gravados em poucos segundos
+    FILE* obj = fopen(objPath.c_str(), "w");
+    if (!obj) {
+        cerr << "Falha ao criar arquivo OBJ: " << objPath << endl;
+        return false;
+    }
+    vector<char> buffer(1 << 20);
+    setvbuf(obj, buffer.data(), _IOFBF, buffer.size());
+
+    mt19937 gerador(params.seed);
+    uniform_real_distribution<float> uniforme(0.0f, 6.2831853f);
+    Relevo relevo = { uniforme(gerador), params.size * 0.02f, params.size };
+
+    fprintf(obj, "# Modelo sintetico (SceneGenerator): %zu vertices, faces de %d lados, %d grupos, %d materiais\n",
+            params.vertices, lados, grupos, materiais);
+    fprintf(obj, "mtllib %s\n", mtlPath.c_str());
+
+    // Posições, coordenadas de textura e normais têm a mesma numeração (vértice i usa vt i e vn i)
+    size_t faces = 0;
+    size_t colunas = 0;     // vértices por linha da superfície
+    if (lados <= 4) {
+        colunas = std::max<size_t>(2, (size_t)ceil(sqrt((double)params.vertices)));
+        size_t linhas = std::max<size_t>(2, (params.vertices + colunas - 1) / colunas);
+        float passo = params.size / (colunas - 1);
+
+        for (size_t l = 0; l < linhas; l++) {
+            for (size_t c = 0; c < colunas; c++) {
+                float x = c * passo - params.size * 0.5f, z = l * passo - params.size * 0.5f;
+                float nx, ny, nz;
+                relevo.normal(x, z, nx, ny, nz);
+                fprintf(obj, "v %.5f %.5f %.5f\n", x, relevo.altura(x, z), z);
+                if (params.texCoords) { fprintf(obj, "vt %.5f %.5f\n", (float)c / (colunas - 1), (float)l / (linhas - 1)); }
+                if (params.normals)   { fprintf(obj, "vn %.5f %.5f %.5f\n", nx, ny, nz); }
+            }
+        }
+        faces = (linhas - 1) * (colunas - 1) * (lados == 3 ? 2 : 1);
+    } else {
+        size_t poligonos = std::max<size_t>(1, (params.vertices + lados - 1) / lados);
+        size_t porLinha = (size_t)ceil(sqrt((double)poligonos));
+        float passo = params.size / porLinha;
+        float raio = passo * 0.45f;
+
+        for (size_t p = 0; p < poligonos; p++) {
+            float cx = (p % porLinha + 0.5f) * passo - params.size * 0.5f;
+            float cz = (p / porLinha + 0.5f) * passo - params.size * 0.5f;
+            float cy = relevo.altura(cx, cz);
+            for (int k = 0; k < lados; k++) {
+                float angulo = 6.2831853f * k / lados;
+                fprintf(obj, "v %.5f %.5f %.5f\n", cx + raio * cos(angulo), cy, cz - raio * sin(angulo));
+                if (params.texCoords) { fprintf(obj, "vt %.5f %.5f\n", 0.5f + 0.5f * cos(angulo), 0.5f + 0.5f * sin(angulo)); }
+                if (params.normals)   { fprintf(obj, "vn 0 1 0\n"); }
+            }
+        }
+        faces = poligonos;
+    }
+
+    // Faces divididas igualmente entre os grupos; o grupo g usa o material g % materiais
+    for (int g = 0; g < grupos; g++) {
+        size_t inicio = faces * g / grupos, fim = faces * (g + 1) / grupos;
+        if (inicio == fim) continue;
+
+        fprintf(obj, "g grupo%d\nusemtl material%d\n", g, g % materiais);
+        for (size_t f = inicio; f < fim; f++) {
+            fprintf(obj, "f");
+            if (lados <= 4) {
+                size_t celula = lados == 3 ? f / 2 : f;
+                size_t a = (celula / (colunas - 1)) * colunas + celula % (colunas - 1) + 1;    // índices começam em 1
+                size_t b = a + 1, c = a + colunas + 1, d = a + colunas;
+                size_t cantos[4] = { a, d, c, b };      // sentido anti-horário visto de cima (+Y)
+                if (lados == 3) {
+                    if (f % 2 == 0) { cantos[0] = a; cantos[1] = d; cantos[2] = b; }
+                    else            { cantos[0] = b; cantos[1] = d; cantos[2] = c; }
+                }
+                for (int k = 0; k < lados; k++) { writeCorner(obj, cantos[k], cantos[k], cantos[k], params.texCoords, params.normals); }
+            } else {
+                for (int k = 0; k < lados; k++) {
+                    size_t v = f * lados + k + 1;
+                    writeCorner(obj, v, v, v, params.texCoords, params.normals);
+                }
+            }
+            fprintf(obj, "\n");
+        }
+    }
+
+    bool gravado = ferror(obj) == 0;
+    fclose(obj);
+    if (!gravado) { cerr << "Falha ao gravar arquivo OBJ: " << objPath << endl; }
+    return gravado;
+}
+
+
+bool SceneGenerator::writeMTL(const string& path, int count) {
+    ofstream mtl(path);
+    if (!mtl.is_open()) {
+        cerr << "Falha ao criar arquivo MTL: " << path << endl;
+        return false;
+    }
+
+    mtl << "# Materiais sinteticos (SceneGenerator): " << count << " materiais sem textura" << endl;
+    for (int i = 0; i < count; i++) {
+        // cores difusas distribuídas pelo círculo de matizes
+        float matiz = 6.2831853f * i / std::max(count, 1);
+        mtl << endl << "newmtl material" << i << endl
+            << "Ka 0.2 0.2 0.2" << endl
+            << "Kd " << 0.5f + 0.4f * cos(matiz) << " " << 0.5f + 0.4f * cos(matiz - 2.094f) << " "
+                     << 0.5f + 0.4f * cos(matiz + 2.094f) << endl
+            << "Ks 0.5 0.5 0.5" << endl
+            << "Ns 32" << endl
+            << "d 1.0" << endl
+            << "illum 2" << endl;
+    }
+    return true;
+}
+
+
+bool SceneGenerator::writeScene(const string& path, const SceneParams& params) {
+    ofstream cena(path);
+    if (!cena.is_open()) {
+        cerr << "Falha ao criar arquivo de cena: " << path << endl;
+        return false;
+    }
+
+    cena << "# Cena sintetica (SceneGenerator): " << params.objects << " obstaculos, " << params.targets
+         << " alvos eliminaveis, " << params.vehicles << " veiculos animados" << endl;
+    cena << "# Formato: nome caminhoDoModelo posX posY posZ rotX rotY rotZ escalaX escalaY escalaZ eliminavel (1/0)" << endl;
+    cena << endl;
+    cena << "# # # = CONFIGURAÇÕES DO SISTEMA = # # #" << endl;
+    cena << "CAMERA       0.0  3.0  10.0" << endl;
+    cena << "LIGHT        0.0 10.0  0.0   2.0  2.0  1.8" << endl;
+    cena << "ATTENUATION  1.0  0.045  0.0075" << endl;
+    cena << "FOG          0  0.9 0.9 0.9  0.08  10.0  50.0  1" << endl;
+    cena << "SIMULATION   120  8  1" << endl;
+    cena << "JOBS         -1" << endl;
+    cena << "ASSETS       2  8" << endl;
+    cena << endl;
+    cena << "# # # == OBJETOS DA CENA == # # #" << endl;
+
+    char linha[512];
+
+    // Pista: chão da cena e referência da curva de animação dos veículos (ver System::loadSceneObjects)
+    if (params.track) {
+        cena << "Pista models/pista.obj 0.0 0.0 -5.0 0 0 0 1.0 1.0 1.0 0" << endl;
+    }
+
+    // Veículos: todos com nome "Veiculo..." para que recebam a curva; a simulação os espalha ao longo dela
+    for (size_t i = 0; i < params.vehicles; i++) {
+        snprintf(linha, sizeof(linha), "Veiculo%04zu %s 0.0 0.1 -2.0 0 0 0 0.1 0.1 0.1 1",
+                 i + 1, params.vehicleModel.c_str());
+        cena << linha << endl;
+    }
+
+    // Obstáculos e alvos em posições e rotações aleatórias (semente fixa) dentro da área
+    mt19937 gerador(params.seed);
+    uniform_real_distribution<float> posicao(-params.area * 0.5f, params.area * 0.5f);
+    uniform_real_distribution<float> rotacao(0.0f, 360.0f);
+
+    for (size_t i = 0; i < params.objects; i++) {
+        const string& modelo = params.objectModels.empty() ? params.targetModel
+                                                           : params.objectModels[i % params.objectModels.size()];
+        float x = posicao(gerador), z = posicao(gerador), rot = rotacao(gerador);
+        snprintf(linha, sizeof(linha), "Obstaculo%06zu %s %.3f 0.0 %.3f 0 %.1f 0 0.5 0.5 0.5 0",
+                 i + 1, modelo.c_str(), x, z, rot);
+        cena << linha << endl;
+    }
+    for (size_t i = 0; i < params.targets; i++) {
+        float x = posicao(gerador), z = posicao(gerador), rot = rotacao(gerador);
+        snprintf(linha, sizeof(linha), "Alvo%06zu %s %.3f 1.0 %.3f 0 %.1f 0 0.5 0.5 0.5 1",
+                 i + 1, params.targetModel.c_str(), x, z, rot);
+        cena << linha << endl;
+    }
+    return true;
+}
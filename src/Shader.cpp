@@ -1,7 +1,19 @@
 #include "Shader.h"
+#include "RenderStats.h"
+#include "UniformBuffer.h"
 #include <iostream>
 
-Shader::Shader() : ID(0) {}
+// Nomes dos uniforms no código GLSL, na mesma ordem do enum Shader::Uniform
+static const char* UNIFORM_NAMES[Shader::UNIFORM_COUNT] = {
+    "hasDiffuseMap", "diffuseMap",
+    "objectColor", "isProjectile"
+};
+
+bool Shader::cacheUniforms = true;
+
+Shader::Shader() : ID(0) {
+    for (int& loc : uniformLocations) { loc = -1; }
+}
 
 Shader::~Shader() { cleanup(); }
 
@@ -44,6 +56,8 @@ bool Shader::loadShaders(const string& vertexSource, const string& fragmentSourc
     glDeleteShader(vertShader);
     glDeleteShader(fragShader);
     
+    resolveUniforms();  // Busca as localizações dos uniforms uma única vez
+
     cout << "Shaders compilados com sucesso! (ID: " << ID << ")" << endl;
     cout << endl;
 
@@ -51,6 +65,53 @@ bool Shader::loadShaders(const string& vertexSource, const string& fragmentSourc
 }
 
 
+// Resolve a localização de todos os uniforms do enum no programa recém linkado
+// e liga os blocos de uniforms do programa aos pontos de ligação compartilhados
+void Shader::resolveUniforms() {
+    for (int i = 0; i < UNIFORM_COUNT; i++) {
+        uniformLocations[i] = glGetUniformLocation(ID, UNIFORM_NAMES[i]);
+    }
+
+    unsigned int frameBlock = glGetUniformBlockIndex(ID, "FrameData");
+    if (frameBlock != GL_INVALID_INDEX) { glUniformBlockBinding(ID, frameBlock, FRAME_BINDING); }
+
+    unsigned int materialBlock = glGetUniformBlockIndex(ID, "MaterialData");
+    if (materialBlock != GL_INVALID_INDEX) { glUniformBlockBinding(ID, materialBlock, MATERIAL_BINDING); }
+}
+
+
+int Shader::location(Uniform uniform) const {
+    if (cacheUniforms) { return uniformLocations[uniform]; }
+
+    RenderStats::uniformLookups++;  // caminho antigo: busca pelo nome a cada envio
+    return glGetUniformLocation(ID, UNIFORM_NAMES[uniform]);
+}
+
+
+void Shader::setInt(Uniform uniform, int value) const {
+    glUniform1i(location(uniform), value);
+    RenderStats::uniformUploads++;
+}
+
+
+void Shader::setFloat(Uniform uniform, float value) const {
+    glUniform1f(location(uniform), value);
+    RenderStats::uniformUploads++;
+}
+
+
+void Shader::setVec3(Uniform uniform, const vec3& value) const {
+    glUniform3fv(location(uniform), 1, value_ptr(value));
+    RenderStats::uniformUploads++;
+}
+
+
+void Shader::setMat4(Uniform uniform, const mat4& value) const {
+    glUniformMatrix4fv(location(uniform), 1, GL_FALSE, value_ptr(value));
+    RenderStats::uniformUploads++;
+}
+
+
 unsigned int Shader::compileShader(const string& source, GLenum shaderType) const {
 
     unsigned int shader = glCreateShader(shaderType);
@@ -98,4 +159,5 @@ void Shader::cleanup() {
         glDeleteProgram(ID);
         ID = 0;
     }
+    for (int& loc : uniformLocations) { loc = -1; }
 }
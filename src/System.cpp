@@ -1,22 +1,63 @@
 #include "System.h"
 #include "Texture.h"
+#include "RenderStats.h"
+#include "RenderQueue.h"
+#include "ModelRegistry.h"
+#include "CollisionKernels.h"
+#include "FrameStats.h"
+#include "ImageWriter.h"
+#include "Profiler.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <filesystem>
+#include <cstdio>
 
 // Variáveis estáticas para controle de entrada
 static System* systemInstance = nullptr;
 static bool tiroDisparado = false;
 static bool fogTogglePressed = false;
+static bool uniformTogglePressed = false;
+static bool renderStatsPressed = false;
+static bool kernelTogglePressed = false;
+static bool rajadaDisparada = false;
+static bool benchmarkPressed = false;
+static bool profilePressed = false;
 
 // Grau B - Carrega configurações do sistema (câmera, luz, fog) também a partir do arquivo
 // "Configurador_Sistema.txt", assim como os objetos da cena, de forma que configurações
 // de camera, iluminação e fog podem ser ajustadas neste arquivo sem a necessidade de recompilar o código
 System::System() : window(nullptr), 
+                   scenePath("Configurador_Cena.txt"),
+                   profilePath("perfil_cpu.json"),
+                   headless(false),
+                   headlessContext("egl"),
+                   offscreenFBO(0),
+                   offscreenColor(0),
+                   offscreenDepth(0),
+                   fixedClock(-1.0),
                    camera(vec3(0.0f, 2.0f, 20.0f)), // valores padrão, serão sobrescritos
                    deltaTime(0.0f),
                    lastFrame(0.0f),
+                   fixedStep(1.0f / 120.0f),
+                   maxStepsPerFrame(8),
+                   accumulator(0.0f),
+                   simulationTick(0),
+                   simulationThreaded(true),
+                   simulationRunning(false),
+                   stepDelta(0.0f),
+                   animationTask(-1),
+                   projectileTask(-1),
+                   collisionTask(-1),
+                   loaderThreads(2),
+                   uploadBudgetBytes(8 * 1024 * 1024),
+                   loadStartTime(0.0),
+                   objectsLoaded(0),
+                   loadReported(false),
                    firstMouse(true),
                    lastX(SCREEN_WIDTH  / 2.0f),
                    lastY(SCREEN_HEIGHT / 2.0f),
@@ -30,7 +71,16 @@ System::System() : window(nullptr),
                    fogStart(10.0f),
                    fogEnd(50.0f),
                    fogType(1),
-                   fogEnabled(true)
+                   fogEnabled(true),
+                   trackPosition(0.0f),
+                   trackRotation(0.0f),
+                   trackScale(1.0f),
+                   lastCollisionMicros(0.0),
+                   lastSimulationReport(0.0),
+                   projectilesSpawned(0),
+                   impactBounces(0),
+                   impactEliminations(0),
+                   quietImpacts(false)
 {
     systemInstance = this;
 }
@@ -43,17 +93,34 @@ System::~System() { }
 // Função de limpeza e desligamento do sistema
 void System::shutdown() {
     // Fluxo de limpeza:
-    // 1. Limpar objetos da cena (libera VAO e VBO de cada objeto)
+    // 0. Encerrar a thread de simulação (nada abaixo pode ser liberado enquanto ela roda)
+    // 1. Limpar objetos da cena e o registro de modelos (libera VAO, VBO e EBO de cada modelo)
     // 2. Limpar projéteis (libera recursos gráficos dos projéteis)
     // 3. Limpar cache de texturas (chama glDeleteTextures para cada textura)
-    // 4. Destruir janela GLFW (destrói contexto OpenGL)
-    // 5. Terminar GLFW (libera recursos da biblioteca)
+    // 4. Liberar os buffers dos blocos de uniforms (quadro e material padrão), o cubo dos projéteis
+    //    e o framebuffer da execução sem janela
+    // 5. Destruir janela GLFW (destrói contexto OpenGL)
+    // 6. Terminar GLFW (libera recursos da biblioteca)
+
+    stopSimulation();     // aguarda o fim do passo em andamento
+    assetLoader.stop();   // e o fim dos carregamentos em andamento (as malhas não enviadas não têm recursos OpenGL)
+    pendingObjects.clear();
+    for (auto& pedido : pendingCommands) { delete pedido.objeto; }  // objetos carregados que não chegaram à cena
+    pendingCommands.clear();
     
     sceneObjects.clear(); // remove todos os objetos da cena e chama os destrutores de cada objeto
-    projeteis.clear(); // remove todos os projéteis da cena e chama os destrutores de cada objeto
+    broadPhase.clear();   // e as suas caixas da broad phase
+    projeteis.clear(); // desativa todos os projéteis da cena
+    ModelRegistry::clear(); // libera as malhas compartilhadas (VAO, VBO e EBO de cada modelo)
     
     // Limpa o cache de texturas, liberando recursos da GPU
     Texture::clearCache();
+
+    // Libera os buffers dos blocos de uniforms enquanto o contexto OpenGL ainda existe
+    frameUniforms.cleanup();
+    defaultMaterial.cleanup();
+    projetilRenderer.cleanup();
+    destroyOffscreenTarget();
     
     if (window) {
         glfwDestroyWindow(window);
@@ -68,12 +135,28 @@ void System::shutdown() {
 // Inicializa a GLFW (janela, contexto, callbacks)
 bool System::initializeGLFW() {
 
+    // Sem janela: plataforma "null" da GLFW (não precisa de servidor gráfico nem de monitor)
+    if (headless) { glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL); }
+
     // GLFW: Inicialização e configurações de versão do OpenGL
-    glfwInit(); // Inicialização da GLFW
+    if (!glfwInit()) { // Inicialização da GLFW
+        cerr << "Falha ao inicializar a biblioteca GLFW" << endl;
+        return false;
+    }
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);  // Informa a versão do OpenGL a partir da qual o código funcionará
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);  // Exemplo para versão 3.3 - adaptar para a versão suportada por sua placa
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 	glfwWindowHint(GLFW_SAMPLES, 4);  // Ativa MSAA 4x (Multisample Anti-Aliasing) - suaviza bordas serrilhadas
+
+    // Sem janela: contexto EGL sem superfície (EGL_MESA_platform_surfaceless) ou OSMesa, ambos atendidos pelo
+    // llvmpipe do Mesa em máquinas sem GPU; 4.5 é a versão mais alta do llvmpipe e os shaders pedem só a 4.0.
+    // O desenho vai para o framebuffer criado em initializeOpenGL, então a janela invisível não tem amostras
+    if (headless) {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, headlessContext == "osmesa" ? GLFW_OSMESA_CONTEXT_API : GLFW_EGL_CONTEXT_API);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_SAMPLES, 0);
+    }
     
     window = glfwCreateWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "GRAU B - Ian R. Boniatti e Eduardo Tropea", NULL, NULL);
 
@@ -112,6 +195,12 @@ bool System::initializeOpenGL() {
     // Ativa multisampling para antialiasing (suaviza bordas serrilhadas) - Pesquisado na internet
     glEnable(GL_MULTISAMPLE);
 
+    // Sem janela, todo o desenho vai para um framebuffer próprio (um contexto EGL sem superfície não tem o padrão)
+    if (headless && !createOffscreenTarget()) {
+        cerr << "Falha ao criar o framebuffer da execucao sem janela" << endl;
+        return false;
+    }
+
     // Definindo as dimensões da viewport
     glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
     
@@ -126,30 +215,58 @@ bool System::initializeOpenGL() {
 
 // Alteramos para o Grau B - inclusão da Iluminação de Phong e mapeamento de texturas obtidas a partir do arquivo MTL
 bool System::loadShaders() {
+    PROFILE_ZONE("System::loadShaders");
     // Código fonte do Vertex Shader com iluminação de Phong
     string vertexShaderSource = R"(
         #version 400 core
         layout (location = 0) in vec3 coordenadasDaGeometria;
         layout (location = 1) in vec2 coordenadasDaTextura;
         layout (location = 2) in vec3 coordenadasDaNormal;
+        layout (location = 3) in mat4 instanceModel;  // matriz de modelo por instância (locations 3 a 6)
+        layout (location = 7) in vec4 instanceOffset; // projéteis: posição (xyz) e escala (w) por instância
         
         out vec2 textureCoord;    // Coordenadas de textura do vértice
         out vec3 elementPosition; // No VS representa a posição do vértice no world space   // antes era fragPos
         out vec3 worldNormal;     // Vetor normal no world space
 
-        uniform mat4 model;        // Matriz que aplica as transformações ao objeto (translação, rotação, escala)
-        uniform mat4 view;         // Matriz de visualização da câmera (posição, direção, etc.)
-        uniform mat4 projection;   // Matriz de projeção escolhida (perspectiva ou ortográfica)
-        uniform bool isProjectile; // flag para diferenciar projéteis de objetos da cena
+        // Estado por quadro (câmera, luz, atenuação e fog), gravado uma vez por quadro - ver UniformBuffer.h
+        layout (std140) uniform FrameData {
+            mat4  projection;      // Matriz de projeção escolhida (perspectiva ou ortográfica)
+            mat4  view;            // Matriz de visualização da câmera (posição, direção, etc.)
+            vec4  lightPos;        // Posição da luz (xyz)
+            vec4  lightIntensity;  // Intensidade/Cor da luz (rgb)
+            vec4  viewPos;         // Posição da câmera (xyz)
+            vec4  fogColor;        // Cor do fog (rgb)
+            float attConstant;     // Atenuação constante  (c1 nos slides de iluminação)
+            float attLinear;       // Atenuação linear     (c2 nos slides de iluminação)
+            float attQuadratic;    // Atenuação quadrática (c3 nos slides de iluminação)
+            float fogDensity;      // Densidade do fog (para fog exponencial)
+            float fogStart;        // Início do fog (para fog linear)
+            float fogEnd;          // Fim do fog (para fog linear)
+            bool  fogEnabled;      // Flag para ligar/desligar o fog
+            int   fogType;         // 0=linear, 1=exponencial, 2=exponencial²
+        };
+
+        uniform bool isProjectile;  // flag para diferenciar projéteis de objetos da cena
         
         void main() {
 
-            vec4 worldPos = model * vec4(coordenadasDaGeometria, 1.0);  // Posição dos vértices antes de view e da projeção (world space)
+            // Objetos da cena e projéteis são desenhados por instanciamento: os objetos recebem a matriz
+            // de modelo completa e os projéteis apenas posição e escala (cubo sem rotação)
+            mat4 modelMatrix = instanceModel;
+            if (isProjectile) {
+                modelMatrix = mat4(vec4(instanceOffset.w, 0.0, 0.0, 0.0),
+                                   vec4(0.0, instanceOffset.w, 0.0, 0.0),
+                                   vec4(0.0, 0.0, instanceOffset.w, 0.0),
+                                   vec4(instanceOffset.xyz, 1.0));
+            }
+
+            vec4 worldPos = modelMatrix * vec4(coordenadasDaGeometria, 1.0);  // Posição dos vértices antes de view e da projeção (world space)
             elementPosition = worldPos.xyz;                             // Converte vec4 para vec3
 
             gl_Position = projection * view * worldPos;                 // Posição final do vértice após todas as transformações
             
-            worldNormal = mat3(transpose(inverse(model))) * coordenadasDaNormal; // transforma a normal para o world space
+            worldNormal = mat3(transpose(inverse(modelMatrix))) * coordenadasDaNormal; // transforma a normal para o world space
                                                                             // usando transposta da inversa da matriz de modelo
                                                                             // fonte: LearnOpenGL.com
             // Passa coordenadas de textura
@@ -158,14 +275,14 @@ bool System::loadShaders() {
         }
     )";
     // Inputs globais (uniforms) do pipeline:
-        // "model"        matriz de transformações a serem aplicadas ao objeto (translação, rotação, escala)
-        // "view"         matriz de visualização da câmera (posição, direção, etc.)
-        // "projection"   matriz de projeção escolhida (perspectiva ou ortográfica)
+        // "FrameData"    bloco de uniforms com view, projection, luz, atenuação e fog (compartilhado com o FS)
         // "isProjectile" flag para diferenciar projéteis de objetos da cena
     // Inputs do Vertex Shader:
 	    // "coordenadasDaGeometria" recebe as informações que estão no local 0 -> definidas em glVertexAttribPointer(0, xxxxxxxx);
 		// "coordenadasDaTextura"   recebe as informações que estão no local 1 -> definidas em glVertexAttribPointer(1, xxxxxxxx);
         // "coordenadasDaNormal"    recebe as informações que estão no local 2 -> definidas em glVertexAttribPointer(2, xxxxxxxx);
+        // "instanceModel"          recebe a matriz de modelo de cada instância (locais 3 a 6, glVertexAttribDivisor = 1)
+        // "instanceOffset"         recebe a posição e a escala de cada projétil (local 7, glVertexAttribDivisor = 1)
     // Outputs do Vertex Shader:
         // "elementPosition" enviará ao pipeline a posição do vértice no "world space"
         // "worldNormal"     enviará ao pipeline a normal do vértice no "world space"
@@ -186,29 +303,31 @@ bool System::loadShaders() {
         in vec3 elementPosition;  // No FS representa a posição do fragmento // antes era fragPos
         in vec3 worldNormal;      // NORMAL INTERPOLADA pelo pipeline - // normal do fragmento
         
-        // Propriedades do material
-        uniform vec3 Ka;   // Coeficiente ambiente
-        uniform vec3 Kd;   // Coeficiente difuso
-        uniform vec3 Ks;   // Coeficiente especular
-        uniform float Ns;  // Expoente especular (shininess)  
-        
-        // Propriedades da luz
-        uniform vec3 lightPos;      // Posição da luz
-        uniform vec3 lightIntensity;    // Intensidade/Cor da luz
-        uniform vec3 viewPos;       // Posição da câmera
-        
-        // Constantes de atenuação da fonte de luz
-        uniform float attConstante;  // Atenuação constante  (c1 nos slides de iluminação)
-        uniform float attLinear;     // Atenuação linear     (c2 nos slides de iluminação)
-        uniform float attQuadratica; // Atenuação quadrática (c3 nos slides de iluminação)
-        
-        // Parâmetros do fog
-        uniform bool  fogEnabled;   // Flag para ligar/desligar o fog
-        uniform vec3  fogColor;     // Cor do fog
-        uniform float fogDensity;   // Densidade do fog (para fog exponencial)
-        uniform float fogStart;     // Início do fog (para fog linear)
-        uniform float fogEnd;       // Fim do fog (para fog linear)
-        uniform int   fogType;      // 0=linear, 1=exponencial, 2=exponencial²
+        // Estado por quadro (câmera, luz, atenuação e fog) - mesmo bloco do Vertex Shader
+        layout (std140) uniform FrameData {
+            mat4  projection;
+            mat4  view;
+            vec4  lightPos;        // Posição da luz (xyz)
+            vec4  lightIntensity;  // Intensidade/Cor da luz (rgb)
+            vec4  viewPos;         // Posição da câmera (xyz)
+            vec4  fogColor;        // Cor do fog (rgb)
+            float attConstant;     // Atenuação constante  (c1 nos slides de iluminação)
+            float attLinear;       // Atenuação linear     (c2 nos slides de iluminação)
+            float attQuadratic;    // Atenuação quadrática (c3 nos slides de iluminação)
+            float fogDensity;      // Densidade do fog (para fog exponencial)
+            float fogStart;        // Início do fog (para fog linear)
+            float fogEnd;          // Fim do fog (para fog linear)
+            bool  fogEnabled;      // Flag para ligar/desligar o fog
+            int   fogType;         // 0=linear, 1=exponencial, 2=exponencial²
+        };
+
+        // Propriedades do material - um trecho do buffer de materiais da malha por lote de desenho
+        layout (std140) uniform MaterialData {
+            vec3  Ka;   // Coeficiente ambiente
+            float Ns;   // Expoente especular (shininess)
+            vec3  Kd;   // Coeficiente difuso
+            vec3  Ks;   // Coeficiente especular
+        };
         
         // Texturas
         uniform sampler2D diffuseMap;   // Mapa de textura difusa
@@ -226,23 +345,23 @@ bool System::loadShaders() {
             else { baseColor = objectColor; }
             
             // CÁLCULO DA ATENUAÇÃO DA LUZ -> fatt = min { 1/(c1 + c2*d + c3*d²) } de acordo com os slides
-            float distance = length(lightPos - elementPosition);
-            float attenuation = 1.0 / (attConstante + attLinear * distance + attQuadratica * (distance * distance));
+            float distance = length(lightPos.xyz - elementPosition);
+            float attenuation = 1.0 / (attConstant + attLinear * distance + attQuadratic * (distance * distance));
             attenuation = min(attenuation, 1.0);    // garante que a atenuação não ultrapasse 1.0
 
             // CÁLCULO DA COMPONENTE AMBIENTE de acordo com os slides
-            vec3 ambient = Ka * lightIntensity * baseColor;
+            vec3 ambient = Ka * lightIntensity.rgb * baseColor;
 
             // CÁLCULO DA COMPONENTE DIFUSA
-            vec3 lightDir = normalize(lightPos - elementPosition);
+            vec3 lightDir = normalize(lightPos.xyz - elementPosition);
             float diff = max(dot(norm, lightDir), 0.0);
-            vec3 diffuse = Kd * diff * attenuation * lightIntensity * baseColor;
+            vec3 diffuse = Kd * diff * attenuation * lightIntensity.rgb * baseColor;
             
             // CÁLCULO DA COMPONENTE ESPECULAR (reflexo brilhante - não usa baseColor)
-            vec3 viewDir = normalize(viewPos - elementPosition);
+            vec3 viewDir = normalize(viewPos.xyz - elementPosition);
             vec3 reflectDir = reflect(-lightDir, norm);
             float spec = pow(max(dot(viewDir, reflectDir), 0.0), Ns);
-            vec3 specular = Ks * spec * attenuation * lightIntensity;
+            vec3 specular = Ks * spec * attenuation * lightIntensity.rgb;
             
             // COR FINAL DO FRAGMENTO (SEM FOG) - Phong: Ambient + Diffuse + Specular
             vec3 finalFragmentColor = ambient + diffuse + specular;
@@ -251,7 +370,7 @@ bool System::loadShaders() {
             if (fogEnabled) {
                 float fogFactor = 0.0;
 
-                float fogDistance = length(viewPos - elementPosition);
+                float fogDistance = length(viewPos.xyz - elementPosition);
                 
                 if      (fogType == 0) { fogFactor = 1 / fogDistance; } // Fog linear - antes era fogFactor = (fogEnd - fogDistance) / (fogEnd - fogStart);
                 
@@ -261,7 +380,7 @@ bool System::loadShaders() {
                 
                 fogFactor = clamp(fogFactor, 0.0, 1.0);  // garante que o fator fique entre 0 e 1
                 
-                finalFragmentColor = mix(fogColor, finalFragmentColor, fogFactor); // Interpola entre a cor do objeto e a cor do fog
+                finalFragmentColor = mix(fogColor.rgb, finalFragmentColor, fogFactor); // Interpola entre a cor do objeto e a cor do fog
             }
             
             FragColor = vec4(finalFragmentColor, 1.0); // envia a cor final do fragmento para o pipeline ()
@@ -272,20 +391,34 @@ bool System::loadShaders() {
     if (!mainShader.loadShaders(vertexShaderSource, fragmentShaderSource)) {
         return false;
     }
+
+    // Cria os buffers dos blocos de uniforms: estado por quadro (regravado a cada quadro)
+    // e material padrão dos projéteis (coeficientes ambiente, difuso, especular e shininess)
+    frameUniforms.create(sizeof(FrameUniforms));
+
+    MaterialUniforms material = {};
+    material.Ka = vec3(0.1f, 0.1f, 0.1f);
+    material.Kd = vec3(0.8f, 0.8f, 0.8f);
+    material.Ks = vec3(1.0f, 1.0f, 1.0f);
+    material.Ns = 32.0f;
+    defaultMaterial.create(sizeof(MaterialUniforms), &material, GL_STATIC_DRAW);
+
+    projetilRenderer.setup();   // cubo compartilhado por todos os projéteis
     
     return true;
 }
 
 
 // Carrega configurações da cena (câmera, luz, fog) do arquivo de configuração
-// de cena - "Configurador_Cena.txt" - evita a necessidade de recompilar o código
+// de cena - "Configurador_Cena.txt" ou o indicado por --scene - evita a necessidade de recompilar o código
 // para alterar parâmetros como posição da câmera, luz e fog
 bool System::loadSystemConfiguration() {
+    PROFILE_ZONE("System::loadSystemConfiguration");
 
-    ifstream configFile("Configurador_Cena.txt");
+    ifstream configFile(scenePath);
 
     if (!configFile.is_open()) {
-        cerr << "Aviso: Nao foi possivel abrir Configurador_Cena.txt para configuracoes do sistema" << endl;
+        cerr << "Aviso: Nao foi possivel abrir " << scenePath << " para configuracoes do sistema" << endl;
         return false;
     }
     
@@ -323,6 +456,34 @@ bool System::loadSystemConfiguration() {
             cout << "Fog configurado => Habilitado: " << (fogEnabled ? "Sim" : "Nao")
                  << " Tipo: " << fogType << " Densidade: " << fogDensity << endl;
         }
+        else if (keyword == "SIMULATION") {
+            float hz;
+            int maxSteps;
+            if (sline >> hz >> maxSteps && hz > 0.0f && maxSteps > 0) {
+                fixedStep = 1.0f / hz;
+                maxStepsPerFrame = maxSteps;
+            }
+            int threaded;
+            if (sline >> threaded) { simulationThreaded = (threaded == 1); }
+            cout << "Simulacao configurada => " << 1.0f / fixedStep << " Hz, ate "
+                 << maxStepsPerFrame << " passos por quadro, "
+                 << (simulationThreaded ? "em thread propria" : "na thread de renderizacao") << endl;
+        }
+        else if (keyword == "ASSETS") {
+            int threads;
+            float megabytes;
+            if (sline >> threads >> megabytes && threads > 0 && megabytes > 0.0f) {
+                loaderThreads = threads;
+                uploadBudgetBytes = (size_t)(megabytes * 1024.0f * 1024.0f);
+            }
+            cout << "Carregamento em segundo plano => " << loaderThreads << " threads, ate "
+                 << uploadBudgetBytes / (1024.0f * 1024.0f) << " MB enviados por quadro" << endl;
+        }
+        else if (keyword == "JOBS") {
+            int workers;
+            if (sline >> workers) { jobs.resize(workers); }
+            cout << "Threads de trabalho: " << jobs.workerCount() << endl;
+        }
     }
     
     configFile.close();
@@ -334,65 +495,131 @@ bool System::loadSystemConfiguration() {
 
 
 // Carrega os objetos na cena
+// Os objetos são configurados aqui, mas os seus modelos são lidos em segundo plano (AssetLoader): cada objeto
+// espera em pendingObjects e entra na cena quando a malha do seu modelo chega à GPU (ver processLoadedAssets)
 bool System::loadSceneObjects() {
+    PROFILE_ZONE("System::loadSceneObjects");
                                                   // na apresentação: ver readObjectsInfos() (está logo abaixo)
     auto sceneObjectsInfos = readObjectsInfos();  // a partir do arquivo de configuração, lê as configurações gerais
                                                   // dos objetos da cena (nome, path do modelo, posição, rotação, escala, eliminável)
                                                   // e retorna um vetor (sceneObjectsInfo) de estruturas ObjectInfo
 
+    // Veículos: "Veiculo..." (Veiculo, Veiculo0001, ...) ou "Conversivel" percorrem a curva da pista
+    auto isVehicle = [](const string& nome) { return nome.rfind("Veiculo", 0) == 0 || nome == "Conversivel"; };
+    size_t totalVeiculos = count_if(sceneObjectsInfos.begin(), sceneObjectsInfos.end(),
+                                    [&](const ObjectInfo& info) { return isVehicle(info.name); });
+    size_t veiculo = 0;
+
+    // Busca os parâmetros da pista para aplicar às curvas (sem pista, as curvas ficam em coordenadas de mundo)
+    trackPosition = vec3(0.0f);
+    trackRotation = vec3(0.0f);
+    trackScale = vec3(1.0f);
+    for (const auto& obj : sceneObjectsInfos) {
+        if (obj.name == "Pista") {
+            trackPosition = obj.position;
+            trackRotation = obj.rotation;
+            trackScale = obj.scale;
+            break;
+        }
+    }
+
     for (auto& sceneObject : sceneObjectsInfos) { // loop para processar cada configuração de objeto lida do arquivo "configurador_cena.txt"
 
         auto object = make_unique<Object3D>(sceneObject.name);  // cria um novo objeto 3D com o nome especificado
                                                                 // no arquivo de configuração lido acima e armazenado na estrutura sceneObject
 
-        // Tenta carregar o modelo (arquivo .obj), se falhar não adiciona o objeto à cena
+        // O modelo (arquivo .obj) é pedido ao AssetLoader, que o carrega em segundo plano através da sequencia de métodos:
+        // Mesh::loadData -> OBJReader::readFileOBJ (ou MeshCache::load); se falhar, o objeto não entra na cena
         // Grau B: As texturas agora são carregadas através dos arquivos de materiais MTL
-
-        if (object->loadObject(sceneObject.modelPath)) {   // tenta carregar o modelo 3D do arquivo .obj através da sequencia de métodos:
-                                                           // Object3D::loadObject -> Mesh::readObjectModel -> OBJReader::readFileOBJ
-                                                           // que por sua vez chama Mesh::(string& path)
-                                                           // se carregar com sucesso, prossegue para configurar o objeto com os demais parâmetros
-            object->setPosition(sceneObject.position);     // posiciona o objeto na cena
-            object->setRotation(sceneObject.rotation);     // rotaciona o objeto na cena
-            object->baseRotation = sceneObject.rotation;   // guarda rotação inicial para animação
-            object->setScale(sceneObject.scale);           // escala o objeto na cena
-            object->setEliminable(sceneObject.eliminable); // define se o objeto pode ser eliminado ou não
-
-            // Se o objeto é o veículo, carrega a curva de animação 
-            if (sceneObject.name == "Veiculo" || sceneObject.name == "Conversivel") {
-                // Busca os parâmetros da pista para aplicar à curva
-                vec3 trackPos(0.0f), trackRot(0.0f), trackScale(1.0f);
-                for (const auto& obj : sceneObjectsInfos) {
-                    if (obj.name == "Pista") {
-                        trackPos = obj.position;    // posição da pista será aplicada à curva do Veículo
-                        trackRot = obj.rotation;    // rotação da pista será aplicada à curva do Veículo
-                        trackScale = obj.scale;     // escala da pista será aplicada à curva do Veículo
-                        break;
-                    }
-                }
-                
-                // Carrega a curva de animação do veículo aplicando os parâmetros da pista (posição, rotação e escala)
-                if (object->loadAnimationCurve("models/curva_BSpline.txt", trackPos, trackRot, trackScale)) {
-                    object->setAnimationSpeed(4.0f); // Velocidade da animação
-                    //cout << "Animacao carregada para o " << sceneObject.name << endl;
+        object->setPosition(sceneObject.position);     // posiciona o objeto na cena
+        object->setRotation(sceneObject.rotation);     // rotaciona o objeto na cena
+        object->baseRotation = sceneObject.rotation;   // guarda rotação inicial para animação
+        object->setScale(sceneObject.scale);           // escala o objeto na cena
+        object->setEliminable(sceneObject.eliminable); // define se o objeto pode ser eliminado ou não
+        object->beginStep();                           // estado inicial também é o "passo anterior" da interpolação
+        object->collidable = sceneObject.name != "Pista"; // a pista (chão) não participa das colisões com projéteis
+
+        // Se o objeto é o veículo, carrega a curva de animação 
+        if (isVehicle(sceneObject.name)) {
+            // Carrega a curva de animação do veículo aplicando os parâmetros da pista (posição, rotação e escala)
+            if (object->loadAnimationCurve("models/curva_BSpline.txt", trackPosition, trackRotation, trackScale)) {
+                object->setAnimationSpeed(4.0f); // Velocidade da animação
+                //cout << "Animacao carregada para o " << sceneObject.name << endl;
+
+                // Com vários veículos (cenas geradas pelo SceneGenerator), cada um parte de um ponto diferente da curva
+                if (totalVeiculos > 1) {
+                    object->currentCurveIndex = (int)(veiculo * object->animationPoints.size() / totalVeiculos);
+                    object->setPosition(object->animationPoints[object->currentCurveIndex]);
+                    object->beginStep();
                 }
             }
-
-            sceneObjects.push_back(move(object));   // adiciona o objeto 3D criado à lista de objetos 3D da cena
-                                                    // o vetor sceneObjects é um atributo da classe System, gerado no arquivo System.h
-        }
-        else {
-            cout << "Falha ao carregar objeto " << sceneObject.name
-                 << " de " << sceneObject.modelPath << endl;
+            veiculo++;
         }
 
-        cout << endl;
+        // aguarda a malha do modelo (a caixa na broad phase só é registrada quando o objeto entra na cena)
+        pendingObjects[sceneObject.modelPath].push_back(move(object));
+    }
+
+    // Um pedido por modelo: objetos com o mesmo modelo compartilham a malha (ModelRegistry)
+    loadStartTime = clockSeconds();
+    assetLoader.start(loaderThreads);
+    for (const auto& modelo : pendingObjects) {
+        assetLoader.request(modelo.first);
     }
 
+    cout << sceneObjectsInfos.size() << " objetos aguardando " << pendingObjects.size() << " modelos ("
+         << assetLoader.threadCount() << " threads de carregamento)" << endl;
+    cout << "Nucleos de colisao: " << CollisionKernels::levelName(CollisionKernels::level()) << endl;
+
     return true;
 }
 
 
+// Chamado pela thread do contexto OpenGL a cada quadro: envia à GPU as malhas que o AssetLoader terminou de
+// carregar, até uploadBudgetBytes por quadro (pelo menos uma malha, mesmo que maior que o orçamento), e passa
+// os objetos que as usam para a simulação
+void System::processLoadedAssets() {
+    if (pendingObjects.empty()) return;
+    PROFILE_ZONE("System::processLoadedAssets");
+
+    size_t enviados = 0;
+    AssetLoader::Result modelo;
+    while (enviados < uploadBudgetBytes && assetLoader.takeCompleted(modelo)) {
+        vector<unique_ptr<Object3D>> objetos = move(pendingObjects[modelo.path]);
+        pendingObjects.erase(modelo.path);
+
+        if (!modelo.mesh) {
+            for (auto& objeto : objetos) {
+                cout << "Falha ao carregar objeto " << objeto->name << " de " << modelo.path << endl;
+            }
+            continue;
+        }
+
+        PROFILE_ZONE_DETAIL("Mesh::upload", modelo.path);
+        auto inicio = chrono::steady_clock::now();
+        enviados += modelo.mesh->uploadBytes();
+        modelo.mesh->upload();
+        ModelRegistry::add(modelo.path, modelo.mesh);
+        double envioMs = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+
+        cout << "Modelo " << modelo.path << " pronto: carregado em " << modelo.loadMs << " ms, enviado em "
+             << envioMs << " ms (" << objetos.size() << " objetos)" << endl;
+
+        for (auto& objeto : objetos) {
+            objeto->mesh = modelo.mesh;
+            pushCommand({ SimulationCommand::ADICIONAR_OBJETO, vec3(0.0f), vec3(0.0f), 0, objeto.release() });
+            objectsLoaded++;
+        }
+    }
+
+    if (pendingObjects.empty() && !loadReported) {
+        cout << "Cena carregada em " << (clockSeconds() - loadStartTime) * 1000.0 << " ms: " << objectsLoaded
+             << " objetos usando " << ModelRegistry::models().size() << " modelos" << endl;
+        loadReported = true;
+    }
+}
+
+
 // Carrega em um vetor as informações gerais (nome, path do modelo, posição, rotação, escala, eliminável)
 // dos objetos da cena a partir do arquivo de configuração da cena - "Configurador_Cena.txt".
 // No Grau A era: (Nome Path posX posY posZ rotX rotY rotZ scaleX scaleY scaleZ Eliminável(S/N) TexturePath)
@@ -403,7 +630,7 @@ vector<ObjectInfo> System::readObjectsInfos() {
     vector<ObjectInfo> sceneObjectsInfos;  // ObjectInfo é uma estrutura para armazenar informações sobre um determinado objeto 3D
                                            // sceneObjectsInfo é um vetor que armazena várias dessas estruturas (qtd = nº de objetos da cena)
 
-    ifstream configFile("Configurador_Cena.txt");   // abre o arquivo de configuração para leitura
+    ifstream configFile(scenePath);   // abre o arquivo de configuração para leitura
 
     string line;  // variável temporária para armazenar cada linha lida do arquivo de configuração
 
@@ -417,7 +644,8 @@ vector<ObjectInfo> System::readObjectsInfos() {
         sline >> firstWord; // Lê a primeira palavra da linha para verificar se é uma configuração do sistema
 
         if (firstWord == "CAMERA" || firstWord == "LIGHT" || 
-            firstWord == "ATTENUATION" || firstWord == "FOG") {
+            firstWord == "ATTENUATION" || firstWord == "FOG" || firstWord == "SIMULATION" ||
+            firstWord == "JOBS" || firstWord == "ASSETS") {
             continue;       // Ignora linhas de configuração do sistema
         }
 
@@ -451,7 +679,7 @@ vector<ObjectInfo> System::readObjectsInfos() {
     configFile.close();
 
     // debug: informa se objetos foram carregados
-    if (sceneObjectsInfos.empty()) { cerr << "Nenhum objeto carregado: verifique o arquivo Configurador_Cena.txt" << endl; }
+    if (sceneObjectsInfos.empty()) { cerr << "Nenhum objeto carregado: verifique o arquivo " << scenePath << endl; }
     else { cout << sceneObjectsInfos.size() << " objetos encontradas no arquivo de configuracao de cena." << endl; }
     cout << endl;
 
@@ -461,6 +689,7 @@ vector<ObjectInfo> System::readObjectsInfos() {
 
 // Processa a entrada do usuário
 void System::processInput() {
+    PROFILE_ZONE("System::processInput");
 
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
@@ -475,9 +704,10 @@ void System::processInput() {
     if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
         camera.ProcessKeyboard(RIGHT, deltaTime);
     
-    // Disparo
+    // Disparo: a posição e a direção da câmera vão junto com o pedido, aplicado pela simulação no próximo passo
+    // (posição inicial ligeiramente à frente da câmera para evitar colisão imediata com a própria câmera)
     if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS && !tiroDisparado) {
-        disparo();
+        pushCommand({ SimulationCommand::DISPARO, camera.Position + camera.Front * 0.5f, camera.Front, 1, nullptr });
         tiroDisparado = true;
     }
     if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_RELEASE) {
@@ -493,11 +723,109 @@ void System::processInput() {
     if (glfwGetKey(window, GLFW_KEY_F) == GLFW_RELEASE) {
         fogTogglePressed = false;
     }
+
+    // Teste de carga com tecla P: dispara 100 mil projéteis de uma vez
+    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS && !rajadaDisparada) {
+        pushCommand({ SimulationCommand::DISPARO_EM_MASSA, camera.Position + camera.Front * 0.5f, camera.Front, 100000, nullptr });
+        rajadaDisparada = true;
+    }
+    if (glfwGetKey(window, GLFW_KEY_P) == GLFW_RELEASE) {
+        rajadaDisparada = false;
+    }
+
+    // Toggle do cache de localizações dos uniforms com tecla U (compara as chamadas ao driver por quadro)
+    if (glfwGetKey(window, GLFW_KEY_U) == GLFW_PRESS && !uniformTogglePressed) {
+        Shader::cacheUniforms = !Shader::cacheUniforms;
+        uniformTogglePressed = true;
+        cout << "Cache de uniforms " << (Shader::cacheUniforms ? "ligado" : "desligado (glGetUniformLocation a cada envio)") << endl;
+    }
+    if (glfwGetKey(window, GLFW_KEY_U) == GLFW_RELEASE) {
+        uniformTogglePressed = false;
+    }
+
+    // Liga/desliga a impressão das chamadas ao driver por quadro com tecla R (ver RenderStats)
+    if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS && !renderStatsPressed) {
+        RenderStats::enabled = !RenderStats::enabled;
+        renderStatsPressed = true;
+        cout << "Chamadas ao driver por quadro: impressao " << (RenderStats::enabled ? "ligada" : "desligada") << endl;
+    }
+    if (glfwGetKey(window, GLFW_KEY_R) == GLFW_RELEASE) {
+        renderStatsPressed = false;
+    }
+
+    // Alterna os núcleos SIMD das colisões com tecla K (AVX -> SSE -> escalar -> melhor suportado)
+    // A troca é feita pela simulação, entre dois passos, já que os núcleos são usados por ela
+    if (glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS && !kernelTogglePressed) {
+        pushCommand({ SimulationCommand::ALTERNAR_NUCLEOS, vec3(0.0f), vec3(0.0f), 0, nullptr });
+        kernelTogglePressed = true;
+    }
+    if (glfwGetKey(window, GLFW_KEY_K) == GLFW_RELEASE) {
+        kernelTogglePressed = false;
+    }
+
+    // Benchmark do JobSystem com tecla J: 10 mil objetos animados com 1, 2, 4 e 8 threads (pausa a simulação)
+    if (glfwGetKey(window, GLFW_KEY_J) == GLFW_PRESS && !benchmarkPressed) {
+        pushCommand({ SimulationCommand::BENCHMARK_JOBS, vec3(0.0f), vec3(0.0f), 10000, nullptr });
+        benchmarkPressed = true;
+    }
+    if (glfwGetKey(window, GLFW_KEY_J) == GLFW_RELEASE) {
+        benchmarkPressed = false;
+    }
+
+    // Grava o perfil de CPU (zonas mais recentes de cada thread) com tecla F9 (ver Profiler)
+    if (glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS && !profilePressed) {
+        Profiler::write(profilePath);
+        profilePressed = true;
+    }
+    if (glfwGetKey(window, GLFW_KEY_F9) == GLFW_RELEASE) {
+        profilePressed = false;
+    }
+}
+
+
+// Planos do frustum (dentro: dot(xyz, p) + w >= 0) extraídos das linhas da matriz projeção * visão
+static void extractFrustumPlanes(const mat4& m, vec4 planos[6]) {
+    vec4 linha0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    vec4 linha1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    vec4 linha2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    vec4 linha3(m[0][3], m[1][3], m[2][3], m[3][3]);
+    planos[0] = linha3 + linha0;    // esquerda
+    planos[1] = linha3 - linha0;    // direita
+    planos[2] = linha3 + linha1;    // baixo
+    planos[3] = linha3 - linha1;    // cima
+    planos[4] = linha3 + linha2;    // perto
+    planos[5] = linha3 - linha2;    // longe
 }
 
 
-// Renderiza a cena
+// Caixa do modelo transformada (caixa orientada em mundo) contra os planos: fora só se estiver
+// inteira atrás de algum plano (pode manter objetos perto dos cantos, nunca descarta um visível)
+static bool boxInFrustum(const vec4 planos[6], const BoundingBox& box, const mat4& model) {
+    vec3 centro = vec3(model * vec4((box.pontoMinimo + box.pontoMaximo) * 0.5f, 1.0f));
+    vec3 extensao = (box.pontoMaximo - box.pontoMinimo) * 0.5f;
+    vec3 eixoX = vec3(model[0]) * extensao.x;
+    vec3 eixoY = vec3(model[1]) * extensao.y;
+    vec3 eixoZ = vec3(model[2]) * extensao.z;
+
+    for (int i = 0; i < 6; i++) {
+        vec3 normal = vec3(planos[i]);
+        float raio = fabs(dot(normal, eixoX)) + fabs(dot(normal, eixoY)) + fabs(dot(normal, eixoZ));
+        if (dot(normal, centro) + planos[i].w < -raio) return false;
+    }
+    return true;
+}
+
+
+// Renderiza a cena a partir do snapshot mais recente publicado pela simulação (ver publishSnapshot)
+// Nenhum objeto da simulação é acessado aqui: a thread de simulação pode estar no meio de um passo
 void System::render() {
+    PROFILE_ZONE("System::render");
+
+    const SceneSnapshot& cena = snapshots.read();
+
+    // Fração do passo seguinte ao snapshot já decorrida: interpola do passo anterior (0) ao atual (1)
+    float alpha = (float)((clockSeconds() - cena.stateTime) / fixedStep);
+    alpha = std::min(std::max(alpha, 0.0f), 1.0f);
     
     vec3 bgColor = fogEnabled ? fogColor : vec3(0.85f, 1.0f, 0.85f); // Usa a cor do fog como cor de fundo quando fog estiver ativo
 
@@ -512,89 +840,678 @@ void System::render() {
     mat4 view = camera.GetViewMatrix(); // lookAt(Position, Position + Front, Up)
     
     // Ativa o programa de shader
-    if (mainShader.ID != 0) { glUseProgram(mainShader.ID); }
-    
-    // Configura uniforms de transformação
-    glUniformMatrix4fv(glGetUniformLocation(mainShader.ID, "projection"), 1, GL_FALSE, value_ptr(projection));
-    glUniformMatrix4fv(glGetUniformLocation(mainShader.ID, "view"), 1, GL_FALSE, value_ptr(view));
-    
-    // Configura uniforms de iluminação (modelo de Phong completo)
-    glUniform3fv(glGetUniformLocation(mainShader.ID, "lightPos"), 1, value_ptr(lightPos));
-    glUniform3fv(glGetUniformLocation(mainShader.ID, "lightIntensity"), 1, value_ptr(lightIntensity));
-    glUniform3fv(glGetUniformLocation(mainShader.ID, "viewPos"), 1, value_ptr(camera.Position));
-    
-    // Configura coeficientes de atenuação atmosférica
-    glUniform1f(glGetUniformLocation(mainShader.ID, "attConstant"), attConstant);
-    glUniform1f(glGetUniformLocation(mainShader.ID, "attLinear"), attLinear);
-    glUniform1f(glGetUniformLocation(mainShader.ID, "attQuadratic"), attQuadratic);
+    if (mainShader.ID != 0) { glUseProgram(mainShader.ID); RenderStats::stateChanges++; }
     
-    // Configura parâmetros do fog
-    glUniform1i(glGetUniformLocation(mainShader.ID, "fogEnabled"), fogEnabled);
-    glUniform3fv(glGetUniformLocation(mainShader.ID, "fogColor"), 1, value_ptr(fogColor));
-    glUniform1f(glGetUniformLocation(mainShader.ID, "fogDensity"), fogDensity);
-    glUniform1f(glGetUniformLocation(mainShader.ID, "fogStart"), fogStart);
-    glUniform1f(glGetUniformLocation(mainShader.ID, "fogEnd"), fogEnd);
-    glUniform1i(glGetUniformLocation(mainShader.ID, "fogType"), fogType);
+    // Estado por quadro (transformações, iluminação, atenuação e fog) gravado no bloco "FrameData"
+    // com uma única escrita no buffer, no lugar de um glUniform por parâmetro
+    FrameUniforms frame;
+    frame.projection     = projection;
+    frame.view           = view;
+    frame.lightPos       = vec4(lightPos, 1.0f);
+    frame.lightIntensity = vec4(lightIntensity, 0.0f);
+    frame.viewPos        = vec4(camera.Position, 1.0f);
+    frame.fogColor       = vec4(fogColor, 0.0f);
+    frame.attConstant    = attConstant;     // coeficientes de atenuação atmosférica
+    frame.attLinear      = attLinear;
+    frame.attQuadratic   = attQuadratic;
+    frame.fogDensity     = fogDensity;      // parâmetros do fog
+    frame.fogStart       = fogStart;
+    frame.fogEnd         = fogEnd;
+    frame.fogEnabled     = fogEnabled;
+    frame.fogType        = fogType;
+    frameUniforms.update(&frame, sizeof(frame));
+    frameUniforms.bind(FRAME_BINDING);
+
+    mainShader.setInt(Shader::IS_PROJECTILE, false);   // objetos da cena não são projéteis
     
-    // Configura propriedades do material (valores padrão, podem ser alterados por objeto)
-    glUniform3f(glGetUniformLocation(mainShader.ID, "Ka"), 0.1f, 0.1f, 0.1f); // coeficiente ambiente
-    glUniform3f(glGetUniformLocation(mainShader.ID, "Kd"), 0.8f, 0.8f, 0.8f); // coeficiente difuso
-    glUniform3f(glGetUniformLocation(mainShader.ID, "Ks"), 1.0f, 1.0f, 1.0f); // coeficiente especular
-    glUniform1f(glGetUniformLocation(mainShader.ID, "Ns"), 32.0f);            // expoente especular (shininess)
-    glUniform1i(glGetUniformLocation(mainShader.ID, "isProjectile"), false);  // objetos da cena não são projéteis
-    glUniform3f(glGetUniformLocation(mainShader.ID, "objectColor"), 1.0f, 1.0f, 1.0f);
-    
-    for (const auto& sceneObject : sceneObjects) { // renderiza cada objeto da cena
-        sceneObject->render(mainShader);
+    // Cada objeto da cena acrescenta sua transformação às instâncias da sua malha; depois cada modelo
+    // envia seus lotes de desenho instanciados para a fila, que os ordena por shader/textura/VAO/material
+    // e desenha evitando trocas de estado repetidas (uma chamada por lote, qualquer que seja o número de cópias)
+    // As transformações interpoladas e o teste contra o frustum são calculados em paralelo, por blocos de objetos;
+    // só os visíveis entram nas instâncias das malhas (em sequência, já que as listas de instâncias são compartilhadas)
+    vec4 planos[6];
+    extractFrustumPlanes(projection * view, planos);
+
+    size_t totalObjetos = cena.objects.size();
+    objectTransforms.resize(totalObjetos);
+    objectVisible.resize(totalObjetos);
+    jobs.parallelFor(0, totalObjetos, 256, [&](size_t inicio, size_t fim) {
+        for (size_t i = inicio; i < fim; i++) {
+            const SceneSnapshot::ObjectState& objeto = cena.objects[i];
+            if (!objeto.animated || alpha >= 1.0f) {
+                objectTransforms[i] = objeto.transform;
+            } else {
+                objectTransforms[i] = Object3D::interpolateTransform(objeto.previousPosition, objeto.position,
+                                                                     objeto.previousRotation, objeto.rotation,
+                                                                     objeto.scale, alpha);
+            }
+            objectVisible[i] = boxInFrustum(planos, objeto.mesh->boundingBox, objectTransforms[i]);
+        }
+    });
+
+    renderQueue.clear();
+    for (size_t i = 0; i < totalObjetos; i++) {
+        if (objectVisible[i]) { cena.objects[i].mesh->addInstance(objectTransforms[i]); }
     }
+    for (const auto& model : ModelRegistry::models()) {
+        model.second->submit(renderQueue, mainShader, vec3(0.7f, 0.7f, 0.7f)); // cor padrão: cinza claro
+    }
+    renderQueue.flush(&mainShader);
     
     // Render projeteis
-    glUniform1i(glGetUniformLocation(mainShader.ID, "isProjectile"), true); // agora renderizando projéteis
-    glUniform1i(glGetUniformLocation(mainShader.ID, "hasDiffuseMap"), false); // projéteis não usam texturas
+    mainShader.setInt(Shader::IS_PROJECTILE, true);    // agora renderizando projéteis
+    mainShader.setInt(Shader::HAS_DIFFUSE_MAP, false); // projéteis não usam texturas
+    defaultMaterial.bind(MATERIAL_BINDING);            // projéteis usam o material padrão
     
-    for (const auto& projetil : projeteis) {
-        if (projetil->isActive()) {
-            projetil->draw(mainShader);
+    // Todos os projéteis ativos em uma única chamada instanciada, com o cubo compartilhado
+    // A posição é interpolada entre o início e o fim do último passo de simulação
+    const float escala = 0.05f; // projétil pequeno - ajuste conforme necessário
+    projetilInstances.resize(cena.projetilCurrent.size());
+    jobs.parallelFor(0, projetilInstances.size(), 16384, [&](size_t inicio, size_t fim) {
+        for (size_t i = inicio; i < fim; i++) {
+            projetilInstances[i] = vec4(mix(cena.projetilPrevious[i], cena.projetilCurrent[i], alpha), escala);
         }
+    });
+    projetilRenderer.draw(mainShader, projetilInstances);
+}
+
+
+// realiza o disparo de um projétil a partir da posição e direção da câmera no momento do pedido
+size_t System::disparo(const vec3& origem, const vec3& direcao) {
+    // ocupa um slot livre do conjunto de projéteis (sem alocação)
+    if (projeteis.spawn(origem, direcao, 10.0f, 5.0f) < 0) {
+        cout << "Limite de " << projeteis.capacity() << " projeteis atingido" << endl;
+        return 0;
     }
+    return 1;
 }
 
 
-// realiza o disparo de um projétil a partir da posição e direção da câmera
-void System::disparo() {
-    vec3 projetilPos = camera.Position + camera.Front * 0.5f;  // posição inicial do projétil ligeiramente à frente da câmera
-                                                                    // para evitar colisão imediata com a própria câmera
-    vec3 projetilDir = camera.Front; // Retorna a direção da câmera para disparo
+// Teste de carga: dispara "quantidade" projéteis de uma vez, em direções aleatórias à frente da câmera
+size_t System::disparoEmMassa(const vec3& origem, const vec3& direcao, size_t quantidade) {
+    size_t disparados = 0;
+    for (size_t i = 0; i < quantidade; i++) {
+        vec3 espalhamento = vec3(rand() / (float)RAND_MAX - 0.5f, rand() / (float)RAND_MAX - 0.5f, rand() / (float)RAND_MAX - 0.5f);
+        vec3 projetilDir = direcao + espalhamento;
+        if (projeteis.spawn(origem, projetilDir, 10.0f, 5.0f) < 0) { break; }
+        disparados++;
+    }
+    cout << disparados << " projeteis disparados (" << projeteis.liveCount() << " ativos)" << endl;
+    return disparados;
+}
+
 
-    auto projetil = make_unique<Projetil>(projetilPos, projetilDir, 10.0f, 5.0f); // cria um novo projétil
-    projeteis.push_back(move(projetil));   // adiciona o projétil à lista de projéteis ativos
+// Enfileira um pedido da entrada para a simulação (chamado pela thread principal)
+void System::pushCommand(const SimulationCommand& command) {
+    lock_guard<mutex> trava(commandMutex);
+    pendingCommands.push_back(command);
 }
 
 
-// Atualiza a posição dos projéteis e remove os inativos
-void System::updateProjeteis() {
-    for (auto& projetil : projeteis) {
-        if (projetil->isActive()) {
-            projetil->update(deltaTime);
+// Aplica os pedidos pendentes no início de um passo; a trava só é mantida durante a troca dos vetores
+void System::applyCommands() {
+    {
+        lock_guard<mutex> trava(commandMutex);
+        if (pendingCommands.empty()) return;
+        activeCommands.swap(pendingCommands);
+    }
+
+    for (const SimulationCommand& pedido : activeCommands) {
+        switch (pedido.type) {
+        case SimulationCommand::DISPARO:
+            projectilesSpawned += disparo(pedido.origem, pedido.direcao);
+            break;
+        case SimulationCommand::DISPARO_EM_MASSA:
+            projectilesSpawned += disparoEmMassa(pedido.origem, pedido.direcao, pedido.quantidade);
+            break;
+        case SimulationCommand::ALTERNAR_NUCLEOS: {
+            CollisionKernels::Level atual = CollisionKernels::level();
+            CollisionKernels::setLevel(atual == CollisionKernels::SCALAR ? CollisionKernels::supportedLevel()
+                                                                         : (CollisionKernels::Level)(atual - 1));
+            cout << "Nucleos de colisao: " << CollisionKernels::levelName(CollisionKernels::level()) << endl;
+            break;
+        }
+        case SimulationCommand::BENCHMARK_JOBS:
+            benchmarkJobs(pedido.quantidade);
+            break;
+        case SimulationCommand::ADICIONAR_OBJETO: {
+            unique_ptr<Object3D> objeto(pedido.objeto);
+            // registra a caixa (em mundo) do objeto na broad phase das colisões
+            if (objeto->collidable) {
+                objeto->broadPhaseProxy = broadPhase.insert(objeto->getTransformedBoundingBox(), objeto.get());
+            }
+            sceneObjects.push_back(move(objeto));
+            break;
+        }
         }
     }
-    
-    // Remove projeteis inativos
-    projeteis.erase(remove_if(projeteis.begin(), projeteis.end(),
-                                [](const unique_ptr<Projetil>& projetil) {
-                                    return !projetil->isActive();
-                                }), projeteis.end());
+    activeCommands.clear();
+}
+
+
+// Publica o estado inicial da cena e, se configurado, inicia a thread de simulação
+// Chamado depois de loadSceneObjects; a partir daqui só a simulação altera objetos e projéteis
+void System::startSimulation() {
+    // Grafo de um passo: animações (com a broad phase) e projéteis são independentes; as colisões
+    // varrem o resultado dos dois
+    if (simulationGraph.size() == 0) {
+        animationTask  = simulationGraph.add("animacoes", [this]() { updateAnimations(stepDelta); });
+        projectileTask = simulationGraph.add("projeteis", [this]() { updateProjeteis(stepDelta); });
+        collisionTask  = simulationGraph.add("colisoes", [this]() { checkCollisions(); }, { animationTask, projectileTask });
+    }
+
+    publishSnapshot(clockSeconds());
+
+    if (simulationThreaded) {
+        simulationRunning.store(true);
+        simulationThread = thread(&System::simulationLoop, this);
+    }
+}
+
+
+void System::stopSimulation() {
+    simulationRunning.store(false);
+    if (simulationThread.joinable()) { simulationThread.join(); }
+}
+
+
+// Laço da thread de simulação: simula o tempo decorrido desde a última iteração e dorme até o próximo passo
+// O tempo de quadro da aplicação passa a ser max(simulação, renderização) em vez da soma dos dois
+void System::simulationLoop() {
+    PROFILE_THREAD("simulacao");
+    double anterior = clockSeconds();
+    while (simulationRunning.load()) {
+        double agora = clockSeconds();
+        simulate((float)(agora - anterior));
+        anterior = agora;
+
+        this_thread::sleep_for(chrono::duration<float>(fixedStep - accumulator));
+    }
+}
+
+
+// Copia para o buffer da simulação o estado necessário à renderização e o publica (troca sem travas)
+// stateTime é o instante a que corresponde o passo atual; os vetores de cada buffer são reaproveitados
+void System::publishSnapshot(double stateTime) {
+    SceneSnapshot& cena = snapshots.writeBuffer();
+
+    cena.objects.clear();
+    for (const auto& obj : sceneObjects) {
+        if (!obj->mesh) continue;
+        SceneSnapshot::ObjectState estado;
+        estado.mesh             = obj->mesh.get();  // continua válida mesmo que o objeto seja eliminado (ModelRegistry)
+        estado.animated         = obj->isAnimated;
+        estado.transform        = obj->transform;
+        estado.previousPosition = obj->previousPosition;
+        estado.position         = obj->position;
+        estado.previousRotation = obj->previousRotation;
+        estado.rotation         = obj->rotation;
+        estado.scale            = obj->scale;
+        cena.objects.push_back(estado);
+    }
+
+    projeteis.gatherPositions(cena.projetilPrevious, cena.projetilCurrent);
+
+    cena.stateTime = stateTime;
+    cena.tick = simulationTick;
+
+    cena.liveProjeteis = projeteis.liveCount();
+    cena.projetilMicros = projeteis.lastUpdateMicros;
+    cena.collisionMicros = lastCollisionMicros;
+    cena.tasks.clear();
+    for (size_t i = 0; i < simulationGraph.size(); i++) {
+        cena.tasks.emplace_back(simulationGraph.name((int)i), simulationGraph.micros((int)i));
+    }
+    cena.workers = jobs.workerCount();
+    snapshots.publish();
+}
+
+
+// Relógio monotônico (segundos) compartilhado pelas threads de simulação e renderização
+// Na execução sem janela é o tempo do quadro (fixedClock), de forma que a interpolação não depende da máquina
+double System::clockSeconds() const {
+    if (fixedClock >= 0.0) return fixedClock;
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+// Acumula o tempo do quadro e executa quantos passos fixos couberem nele (no máximo maxStepsPerFrame)
+// O que sobra fica para o próximo quadro e define a interpolação da renderização. Se o limite de passos for
+// atingido (quadro muito longo), o tempo excedente é descartado: a simulação desacelera em vez de acumular
+// cada vez mais passos atrasados. Ao fim, se algum passo foi executado, publica um novo snapshot
+void System::simulate(float frameTime) {
+    PROFILE_ZONE("System::simulate");
+    accumulator += frameTime;
+
+    int passos = 0;
+    while (accumulator >= fixedStep && passos < maxStepsPerFrame) {
+        stepSimulation(fixedStep);
+        accumulator -= fixedStep;
+        passos++;
+    }
+    if (accumulator >= fixedStep) { accumulator = fmod(accumulator, fixedStep); }
+
+    if (passos > 0) { publishSnapshot(clockSeconds() - accumulator); }
+}
+
+
+// Um passo de simulação: animações, projéteis e colisões com o mesmo dt a cada passo
+void System::stepSimulation(float dt) {
+    PROFILE_ZONE("System::stepSimulation");
+    applyCommands();        // disparos e trocas pedidos pela entrada desde o último passo
+
+    for (auto& obj : sceneObjects) {
+        if (obj->isAnimated) { obj->beginStep(); }
+    }
+
+    // Atualiza animações dos objetos e posição dos projéteis (guardando a posição anterior),
+    // depois varre o trecho percorrido por cada projétil no passo (ver startSimulation)
+    stepDelta = dt;
+    simulationGraph.execute(jobs);
+
+    simulationTick++;
+}
+
+
+// Uma vez por segundo (de simulação), imprime o custo de cada etapa do passo enquanto houver projéteis ativos
+// Chamado pela thread principal com os dados do snapshot mais recente: a simulação não escreve no console.
+// Faz parte das estatísticas periódicas da renderização: só imprime com RenderStats::enabled (tecla R, --benchmark)
+void System::reportSimulation() {
+    const SceneSnapshot& cena = snapshots.read();
+    double tempoSimulado = cena.tick * (double)fixedStep;
+    if (!RenderStats::enabled || cena.liveProjeteis == 0 || tempoSimulado - lastSimulationReport < 1.0) return;
+
+    cout << "Projeteis ativos: " << cena.liveProjeteis << " - atualizacao em "
+         << cena.projetilMicros << " us, colisoes em " << cena.collisionMicros << " us (";
+    for (size_t i = 0; i < cena.tasks.size(); i++) {
+        cout << (i ? ", " : "") << cena.tasks[i].first << " " << cena.tasks[i].second << " us";
+    }
+    cout << ", " << cena.workers << " threads de trabalho)" << endl;
+    lastSimulationReport = tempoSimulado;
+}
+
+
+// Atualiza a posição dos projéteis em blocos paralelos; os que expiram no passo são liberados depois da varredura (checkCollisions)
+void System::updateProjeteis(float dt) {
+    PROFILE_ZONE("System::updateProjeteis");
+    projeteis.update(dt, &jobs);
 }
 
 
-// Atualiza as animações dos objetos
-void System::updateAnimations() {
+// Atualiza as animações dos objetos, cada bloco de objetos em uma thread de trabalho
+// Depois, em sequência (a árvore não aceita alterações concorrentes), os objetos animados atualizam sua caixa
+// na broad phase (só reinserida quando sai da caixa engordada)
+void System::updateAnimations(float dt) {
+    PROFILE_ZONE("System::updateAnimations");
+    const size_t BLOCO = 256;
+    jobs.parallelFor(0, sceneObjects.size(), BLOCO, [this, dt](size_t inicio, size_t fim) {
+        for (size_t i = inicio; i < fim; i++) {
+            if (sceneObjects[i]->isAnimated) { sceneObjects[i]->updateAnimation(dt); }
+        }
+    });
+
     for (auto& obj : sceneObjects) {
-        obj->updateAnimation(deltaTime);
+        if (obj->isAnimated && obj->broadPhaseProxy >= 0) {
+            broadPhase.move(obj->broadPhaseProxy, obj->getTransformedBoundingBox());
+        }
+    }
+}
+
+
+// Benchmark do JobSystem: custo por quadro de animar "quantidade" objetos (atualização da curva e das matrizes)
+// com 1, 2, 4 e 8 threads. Os objetos são temporários e seguem uma curva circular própria, de forma que o
+// resultado não depende da cena carregada
+void System::benchmarkJobs(size_t quantidade) {
+    const int QUADROS = 240;
+
+    vector<vec3> curva;
+    for (int i = 0; i < 64; i++) {
+        float angulo = radians(i * 360.0f / 64.0f);
+        curva.push_back(vec3(cos(angulo) * 20.0f, 0.5f, sin(angulo) * 20.0f));
+    }
+
+    vector<unique_ptr<Object3D>> objetos;
+    for (size_t i = 0; i < quantidade; i++) {
+        unique_ptr<Object3D> objeto(new Object3D());
+        objeto->animationPoints = curva;
+        objeto->isAnimated = true;
+        objeto->animationSpeed = 4.0f;
+        objeto->currentCurveIndex = (int)(i % curva.size());
+        objetos.push_back(move(objeto));
+    }
+
+    cout << "Benchmark do JobSystem: " << quantidade << " objetos animados, " << QUADROS << " quadros" << endl;
+    double base = 0.0;
+    for (int threads : { 1, 2, 4, 8 }) {
+        JobSystem conjunto(threads - 1);    // quem chama wait é a última thread
+
+        auto inicio = chrono::steady_clock::now();
+        for (int quadro = 0; quadro < QUADROS; quadro++) {
+            conjunto.parallelFor(0, objetos.size(), 256, [&objetos, this](size_t b, size_t e) {
+                for (size_t i = b; i < e; i++) {
+                    objetos[i]->beginStep();
+                    objetos[i]->updateAnimation(fixedStep);
+                }
+            });
+        }
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count() / QUADROS;
+        if (threads == 1) { base = ms; }
+
+        cout << "  " << threads << " thread(s): " << ms << " ms por quadro (" << base / ms << "x)" << endl;
     }
 }
 
 
+// Texto entre aspas para o relatório JSON (caminhos do Windows têm barras invertidas)
+static string jsonString(const string& texto) {
+    string saida = "\"";
+    for (char c : texto) {
+        if (c == '"' || c == '\\') { saida += '\\'; }
+        saida += c;
+    }
+    return saida + "\"";
+}
+
+
+// Execução roteirizada e reprodutível (--headless ou --benchmark): carrega a cena inteira, então executa
+// options.frames quadros de exatamente um passo de simulação cada (sem thread de simulação, relógio = tempo
+// do quadro), com a câmera seguindo o caminho indicado e os disparos do roteiro. Sem sincronismo vertical:
+// cada quadro é medido do início da entrada até o fim do desenho (glFinish), e cada etapa separadamente -
+// entrada, animações, projéteis e colisões (tarefas do grafo do passo), renderização na CPU e, com uma
+// consulta de tempo da OpenGL, na GPU. Ao final imprime o resumo e, se pedido, grava o relatório JSON,
+// a duração de cada quadro (CSV) e as imagens dos quadros
+bool System::runScripted(const ScriptedRunOptions& options) {
+    srand(options.seed);
+
+    vector<vec3> caminho;
+    if (!options.cameraPath.empty() && !loadCameraPath(options.cameraPath, caminho)) return false;
+
+    vector<ScriptedShot> roteiro;
+    if (!options.scriptPath.empty() && !loadFiringScript(options.scriptPath, roteiro)) return false;
+
+    if (!options.dumpDirectory.empty()) {
+        error_code erro;
+        filesystem::create_directories(options.dumpDirectory, erro);
+        if (erro) {
+            cerr << "Falha ao criar o diretorio " << options.dumpDirectory << ": " << erro.message() << endl;
+            return false;
+        }
+    }
+
+    // A cena inteira antes do primeiro quadro, sem limite de envio por quadro
+    uploadBudgetBytes = (size_t)-1;
+    while (!pendingObjects.empty()) {
+        processLoadedAssets();
+        if (!pendingObjects.empty()) { this_thread::sleep_for(chrono::milliseconds(1)); }
+    }
+
+    // Os objetos entram na cena (e na broad phase) na ordem do nome, não na ordem em que os modelos ficaram prontos
+    stable_sort(pendingCommands.begin(), pendingCommands.end(), [](const SimulationCommand& a, const SimulationCommand& b) {
+        return a.objeto && b.objeto && a.objeto->name < b.objeto->name;
+    });
+    applyCommands();
+
+    simulationThreaded = false;
+    fixedClock = 0.0;
+    quietImpacts = true;    // impactos só contados: o console fora da etapa medida das colisões
+    projectilesSpawned = impactBounces = impactEliminations = 0;
+    startSimulation();
+
+    if (window && !headless) { glfwSwapInterval(0); }  // sem sincronismo vertical: quadros sem limite de taxa
+
+    cout << "Execucao roteirizada" << (headless ? " sem janela" : "") << ": " << options.frames << " quadros de "
+         << fixedStep * 1000.0f << " ms simulados, " << sceneObjects.size() << " objetos, " << roteiro.size()
+         << " disparos no roteiro, " << SCREEN_WIDTH << "x" << SCREEN_HEIGHT << endl;
+
+    FrameStats quadros, entrada, animacoes, projeteisEtapa, colisoes, renderizacao, gpu;
+    for (FrameStats* etapa : { &quadros, &entrada, &animacoes, &projeteisEtapa, &colisoes, &renderizacao, &gpu }) {
+        etapa->reserve(options.frames);
+    }
+
+    GLuint consultaGPU = 0;
+    glGenQueries(1, &consultaGPU);
+
+    size_t proximoDisparo = 0;
+    size_t pedidos = 0, maximoAtivos = 0;
+    int imagens = 0;
+    int quadro = 0;
+    for (; quadro < options.frames; quadro++) {
+        auto inicio = chrono::steady_clock::now();
+
+        // Entrada roteirizada: câmera no ponto do caminho e disparos do quadro, a partir dela
+        if (window && !headless) {
+            glfwPollEvents();
+            if (glfwWindowShouldClose(window)) break;
+        }
+        if (!caminho.empty()) { placeCameraOnPath(caminho, options.frames > 1 ? (float)quadro / (options.frames - 1) : 0.0f); }
+        for (; proximoDisparo < roteiro.size() && roteiro[proximoDisparo].frame <= quadro; proximoDisparo++) {
+            size_t quantidade = roteiro[proximoDisparo].quantidade;
+            pushCommand({ quantidade > 1 ? SimulationCommand::DISPARO_EM_MASSA : SimulationCommand::DISPARO,
+                          camera.Position + camera.Front * 0.5f, camera.Front, quantidade, nullptr });
+            pedidos += quantidade;
+        }
+        auto fimEntrada = chrono::steady_clock::now();
+
+        // Um passo exato por quadro; a renderização vê o fim do passo (interpolação = 1)
+        fixedClock = quadro * (double)fixedStep;
+        simulate(fixedStep);
+        fixedClock = (quadro + 1) * (double)fixedStep;
+        maximoAtivos = std::max(maximoAtivos, projeteis.liveCount());
+
+        auto inicioRender = chrono::steady_clock::now();
+        glBeginQuery(GL_TIME_ELAPSED, consultaGPU);
+        render();
+        glEndQuery(GL_TIME_ELAPSED);
+        auto fimRender = chrono::steady_clock::now();
+
+        glFinish();     // inclui o desenho (no llvmpipe, a rasterização na CPU) na duração do quadro
+
+        // Captura antes da troca de buffers: depois de glfwSwapBuffers o conteúdo do back buffer é indefinido.
+        // A gravação do PNG fica fora da duração do quadro
+        chrono::steady_clock::duration tempoCaptura(0);
+        if (!options.dumpDirectory.empty() && quadro % std::max(options.dumpEvery, 1) == 0) {
+            auto inicioCaptura = chrono::steady_clock::now();
+            char nome[32];
+            snprintf(nome, sizeof(nome), "quadro_%05d.png", quadro);
+            if (dumpFrame((filesystem::path(options.dumpDirectory) / nome).string())) { imagens++; }
+            tempoCaptura = chrono::steady_clock::now() - inicioCaptura;
+        }
+
+        if (window && !headless) {
+            PROFILE_ZONE("glfwSwapBuffers");
+            glfwSwapBuffers(window);
+            glFinish();
+        }
+
+        auto fim = chrono::steady_clock::now();
+
+        GLuint64 nanosGPU = 0;
+        glGetQueryObjectui64v(consultaGPU, GL_QUERY_RESULT, &nanosGPU);  // já disponível depois de glFinish
+
+        quadros.add(chrono::duration<double, milli>(fim - inicio - tempoCaptura).count());
+        entrada.add(chrono::duration<double, milli>(fimEntrada - inicio).count());
+        animacoes.add(simulationGraph.micros(animationTask) / 1000.0);
+        projeteisEtapa.add(simulationGraph.micros(projectileTask) / 1000.0);
+        colisoes.add(simulationGraph.micros(collisionTask) / 1000.0);
+        renderizacao.add(chrono::duration<double, milli>(fimRender - inicioRender).count());
+        gpu.add(nanosGPU / 1.0e6);
+        RenderStats::endFrame((float)fixedClock);
+    }
+    fixedClock = -1.0;
+    quietImpacts = false;
+    glDeleteQueries(1, &consultaGPU);
+
+    quadros.print("Quadros");
+    entrada.print("  entrada");
+    animacoes.print("  animacoes");
+    projeteisEtapa.print("  projeteis");
+    colisoes.print("  colisoes");
+    renderizacao.print("  renderizacao (CPU)");
+    gpu.print("  renderizacao (GPU)");
+    cout << "Projeteis: " << projectilesSpawned << " disparados de " << pedidos << " pedidos" << endl;
+    cout << "Impactos: " << impactBounces << " rebotes, " << impactEliminations << " objetos eliminados" << endl;
+    if (imagens > 0) { cout << imagens << " imagens gravadas em " << options.dumpDirectory << endl; }
+    if (!options.statsPath.empty() && quadros.writeCSV(options.statsPath)) {
+        cout << "Duracao de cada quadro gravada em " << options.statsPath << endl;
+    }
+
+    // Relatório para comparar execuções entre versões (as chaves não mudam de uma versão para outra)
+    if (!options.benchmarkPath.empty()) {
+        ofstream relatorio(options.benchmarkPath);
+        if (!relatorio.is_open()) {
+            cerr << "Falha ao criar relatorio do benchmark: " << options.benchmarkPath << endl;
+            return false;
+        }
+
+        relatorio << "{" << endl;
+        relatorio << "  \"scene\": " << jsonString(scenePath) << "," << endl;
+        relatorio << "  \"cameraPath\": " << jsonString(options.cameraPath) << "," << endl;
+        relatorio << "  \"script\": " << jsonString(options.scriptPath) << "," << endl;
+        relatorio << "  \"seed\": " << options.seed << "," << endl;
+        relatorio << "  \"headless\": " << (headless ? "true" : "false") << "," << endl;
+        relatorio << "  \"renderer\": " << jsonString((const char*)glGetString(GL_RENDERER)) << "," << endl;
+        relatorio << "  \"width\": " << SCREEN_WIDTH << "," << endl;
+        relatorio << "  \"height\": " << SCREEN_HEIGHT << "," << endl;
+        relatorio << "  \"fixedStepMs\": " << fixedStep * 1000.0f << "," << endl;
+        relatorio << "  \"workerThreads\": " << jobs.workerCount() << "," << endl;
+        relatorio << "  \"frames\": " << quadros.size() << "," << endl;
+        relatorio << "  \"objects\": " << sceneObjects.size() << "," << endl;
+        relatorio << "  \"projectilesRequested\": " << pedidos << "," << endl;
+        relatorio << "  \"projectilesFired\": " << projectilesSpawned << "," << endl;
+        relatorio << "  \"maxLiveProjectiles\": " << maximoAtivos << "," << endl;
+        relatorio << "  \"projectileBounces\": " << impactBounces << "," << endl;
+        relatorio << "  \"objectsEliminated\": " << impactEliminations << "," << endl;
+        relatorio << "  \"cpu\": {" << endl;
+        relatorio << "    \"frame\": " << quadros.toJSON() << "," << endl;
+        relatorio << "    \"input\": " << entrada.toJSON() << "," << endl;
+        relatorio << "    \"animation\": " << animacoes.toJSON() << "," << endl;
+        relatorio << "    \"projectiles\": " << projeteisEtapa.toJSON() << "," << endl;
+        relatorio << "    \"collisions\": " << colisoes.toJSON() << "," << endl;
+        relatorio << "    \"render\": " << renderizacao.toJSON() << endl;
+        relatorio << "  }," << endl;
+        relatorio << "  \"gpu\": {" << endl;
+        relatorio << "    \"render\": " << gpu.toJSON() << endl;
+        relatorio << "  }" << endl;
+        relatorio << "}" << endl;
+        cout << "Relatorio do benchmark gravado em " << options.benchmarkPath << endl;
+    }
+    return true;
+}
+
+
+// Cria o framebuffer da execução sem janela (cor RGBA8 e profundidade/stencil) e o deixa em uso
+bool System::createOffscreenTarget() {
+    glGenRenderbuffers(1, &offscreenColor);
+    glBindRenderbuffer(GL_RENDERBUFFER, offscreenColor);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+    glGenRenderbuffers(1, &offscreenDepth);
+    glBindRenderbuffer(GL_RENDERBUFFER, offscreenDepth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+    glGenFramebuffers(1, &offscreenFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, offscreenFBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, offscreenColor);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, offscreenDepth);
+
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+
+void System::destroyOffscreenTarget() {
+    if (offscreenFBO == 0) return;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &offscreenFBO);
+    glDeleteRenderbuffers(1, &offscreenColor);
+    glDeleteRenderbuffers(1, &offscreenDepth);
+    offscreenFBO = offscreenColor = offscreenDepth = 0;
+}
+
+
+// Lê os pontos do caminho da câmera com o leitor das curvas de animação (Object3D::loadAnimationCurve):
+// uma linha "x y z" por ponto, nas coordenadas da pista, como models/curva_BSpline.txt; a transformação
+// da pista lida da cena é aplicada, e a câmera percorre a mesma trajetória dos veículos
+bool System::loadCameraPath(const string& path, vector<vec3>& points) {
+    string nome = "CaminhoCamera";
+    Object3D curva(nome);
+    if (!curva.loadAnimationCurve(path, trackPosition, trackRotation, trackScale)) {
+        cerr << "Caminho da camera sem pontos: " << path << endl;
+        return false;
+    }
+
+    points = move(curva.animationPoints);
+    cout << "Caminho da camera: " << points.size() << " pontos de " << path << endl;
+    return true;
+}
+
+
+// Posiciona a câmera na fração t (0 a 1) do caminho, olhando na direção do trecho em que está
+void System::placeCameraOnPath(const vector<vec3>& points, float t) {
+    if (points.size() == 1) {
+        camera.Position = points[0];
+        return;
+    }
+
+    float posicao = t * (points.size() - 1);
+    size_t trecho = std::min((size_t)posicao, points.size() - 2);
+    float fracao = posicao - trecho;
+
+    camera.Position = mix(points[trecho], points[trecho + 1], fracao);
+
+    vec3 direcao = points[trecho + 1] - points[trecho];
+    if (length(direcao) > 1e-6f) {
+        direcao = normalize(direcao);
+        camera.Yaw = degrees(atan2(direcao.z, direcao.x));
+        camera.Pitch = degrees(asin(glm::clamp(direcao.y, -1.0f, 1.0f)));
+        camera.updateCameraVectors();
+    }
+}
+
+
+// Lê o roteiro de disparos: uma linha "quadro TIRO" ou "quadro RAJADA quantidade" por disparo
+// Os disparos partem da câmera no início do quadro; o espalhamento das rajadas vem de rand() (semente --seed)
+bool System::loadFiringScript(const string& path, vector<ScriptedShot>& shots) {
+    ifstream file(path);
+    if (!file.is_open()) {
+        cerr << "Falha ao abrir roteiro de disparos: " << path << endl;
+        return false;
+    }
+
+    shots.clear();
+    string line;
+    while (getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+
+        istringstream iss(line);
+        ScriptedShot disparo;
+        string tipo;
+        if (!(iss >> disparo.frame >> tipo)) continue;
+
+        if (tipo == "TIRO") {
+            disparo.quantidade = 1;
+        } else if (tipo != "RAJADA" || !(iss >> disparo.quantidade) || disparo.quantidade == 0) {
+            cerr << "Linha invalida no roteiro de disparos: " << line << endl;
+            return false;
+        }
+        shots.push_back(disparo);
+    }
+
+    stable_sort(shots.begin(), shots.end(), [](const ScriptedShot& a, const ScriptedShot& b) { return a.frame < b.frame; });
+    cout << "Roteiro de disparos: " << shots.size() << " disparos de " << path << endl;
+    return true;
+}
+
+
+// Grava o quadro atual do framebuffer em PNG (chamado antes de glfwSwapBuffers: lê o back buffer ou o FBO sem janela)
+bool System::dumpFrame(const string& path) {
+    vector<unsigned char> pixels((size_t)SCREEN_WIDTH * SCREEN_HEIGHT * 3);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+    return ImageWriter::writePNG(path, SCREEN_WIDTH, SCREEN_HEIGHT, 3, pixels.data(), true);
+}
+
+
 // funções de callback estáticas
 void System::framebuffer_size_callback(GLFWwindow* window, int width, int height) {
     glViewport(0, 0, width, height);
@@ -629,57 +1546,181 @@ void System::scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 }
 
 
-// Verifica colisões entre projéteis e objetos da cena - tem problema na reflexão!
+// Verifica colisões entre projéteis e objetos da cena (detecção contínua)
+// Chamado em cada passo depois de updateProjeteis: cada projétil varre o segmento que acabou de percorrer, da posição anterior
+// à atual, de forma que projéteis rápidos ou quadros longos não atravessam objetos finos (como wall.obj).
+// Os projéteis são agrupados em pacotes de 8 raios que descem juntos pelo AABBTree, com cada caixa testada
+// contra o pacote inteiro pelos núcleos SIMD (ver CollisionKernels); só os objetos atravessados passam pelo
+// teste exato contra os triângulos (rayIntersect -> MeshBVH). O custo depende das caixas atravessadas
+// pelo segmento, e não da velocidade do projétil
 void System::checkCollisions() {
+    PROFILE_ZONE("System::checkCollisions");
     const float MIN_DISTANCE = 0.1f; // Distância mínima segura antes de verificar colisões
 
-    for (auto& projetil : projeteis) {
-        if (!projetil->isActive()) continue;
+    auto inicio = chrono::high_resolution_clock::now();
+
+    // 1. Agrupa os segmentos percorridos no passo em pacotes de raios
+    collisionPackets.clear();
+    collisionSlots.clear();
+
+    for (size_t projetil = 0; projetil < projeteis.highWater(); projetil++) {
+        if (!projeteis.isActive(projetil)) continue;
+
+        float speed = projeteis.speed[projetil];
         
         // Só verifica colisões se o projétil já percorreu distância mínima
-        if (projetil->lifetime < MIN_DISTANCE / projetil->speed) {
+        if (projeteis.lifetime[projetil] < MIN_DISTANCE / speed) {
             continue;
         }
 
-        for (auto sceneObject = sceneObjects.begin(); sceneObject != sceneObjects.end();) {
-            // Ignora colisão com a pista
-            if ((*sceneObject)->name == "Pista") {
-                ++sceneObject;
-                continue;
+        // Segmento percorrido neste quadro: da posição anterior à atual, ao longo da direção
+        vec3 anterior = projeteis.previousPosition(projetil);
+        float percurso = length(projeteis.position(projetil) - anterior);
+        if (percurso <= 0.0f) continue;
+
+        if (collisionPackets.empty() || collisionPackets.back().count == RayPacket::PACKET_SIZE) {
+            collisionPackets.push_back(RayPacket());
+            collisionSlots.resize(collisionPackets.size() * RayPacket::PACKET_SIZE);
+        }
+        RayPacket& pacote = collisionPackets.back();
+        collisionSlots[(collisionPackets.size() - 1) * RayPacket::PACKET_SIZE + pacote.count] = projetil;
+        pacote.add(anterior, projeteis.direction(projetil), percurso);
+    }
+
+    // 2. Fase larga e estreita em paralelo: as consultas só leem a árvore, as malhas e os projéteis
+    collisionTargets.assign(collisionSlots.size(), nullptr);
+    collisionHits.resize(collisionSlots.size());
+
+    const size_t PACOTES_POR_BLOCO = 64;
+    jobs.parallelFor(0, collisionPackets.size(), PACOTES_POR_BLOCO, [this](size_t b, size_t e) {
+        for (size_t p = b; p < e; p++) {
+            size_t base = p * RayPacket::PACKET_SIZE;
+            queryCollisionPacket(collisionPackets[p], &collisionSlots[base], &collisionTargets[base], &collisionHits[base]);
+        }
+    });
+
+    // 3. Aplica os impactos em sequência (elimina objetos, reflete projéteis), na ordem dos projéteis
+    collisionEliminated.clear();
+    for (size_t p = 0; p < collisionPackets.size(); p++) {
+        const RayPacket& pacote = collisionPackets[p];
+        for (int i = 0; i < pacote.count; i++) {
+            size_t raio = p * RayPacket::PACKET_SIZE + i;
+            Object3D* atingido = collisionTargets[raio];
+            if (!atingido) continue;
+
+            size_t projetil = collisionSlots[raio];
+            vec3 origem = projeteis.previousPosition(projetil);
+
+            // Objeto eliminado por um projétil anterior já saiu da cena: refaz a varredura sem ele
+            if (find(collisionEliminated.begin(), collisionEliminated.end(), atingido) != collisionEliminated.end()) {
+                atingido = sweepSegment(origem, projeteis.direction(projetil), pacote.tMax[i], collisionHits[raio]);
+                if (!atingido) continue;
             }
-            
-            float distance;
-            
-            // Calcular próxima posição do projétil para verificação de colisão
-            vec3 nextPosition = projetil->position + projetil->direction * projetil->speed * deltaTime;
-            
-            if ((*sceneObject)->rayIntersect(projetil->position, projetil->direction, distance)) {
-                // Verificar se a colisão acontecerá no próximo frame (não imediatamente)
-                if (distance <= projetil->speed * deltaTime * 1.1f && distance > 0.0f) {
-                    if ((*sceneObject)->isEliminable()) {
-                        cout << "Objeto \"" << (*sceneObject)->name << "\" eliminado!" << endl;
-                        sceneObject = sceneObjects.erase(sceneObject);
-                        projetil->desativar();
-                    } else {
-                        // Calcular ponto de impacto mais preciso
-                        vec3 hitPoint = projetil->position + projetil->direction * distance;
-                        BoundingBox bbox = (*sceneObject)->getTransformedBoundingBox();
-                        vec3 center = bbox.center();
-                        vec3 normal = normalize(hitPoint - center);
-                        
-                        // Mover projétil para posição de colisão antes de refletir
-                        projetil->position = hitPoint + normal * 0.01f; // Pequeno offset para evitar re-colisão
-                        projetil->reflect(normal);
-                        cout << "Tiro refletiu em \"" << (*sceneObject)->name << "\"!" << endl;
-                        ++sceneObject;
-                    }
-                    break;
-                } else {
-                    ++sceneObject; // Colisão muito distante, continua verificando
+
+            Object3D* eliminado = resolveImpact(projetil, origem, pacote.tMax[i], atingido, collisionHits[raio]);
+            if (eliminado) { collisionEliminated.push_back(eliminado); }
+        }
+    }
+
+    // 4. Os projéteis que expiraram no passo só saem agora, depois que o seu último trecho foi varrido
+    projeteis.releaseExpired();
+
+    lastCollisionMicros = chrono::duration<double, micro>(chrono::high_resolution_clock::now() - inicio).count();
+}
+
+
+// Consulta a broad phase com um pacote de projéteis e guarda o impacto mais próximo de cada um
+// (atingido[i] = nullptr se o raio i não atinge nada). Não altera a cena: pode rodar em qualquer thread
+void System::queryCollisionPacket(const RayPacket& pacote, const size_t* slots, Object3D** atingido, RayHit* impacto) {
+    for (int i = 0; i < pacote.count; i++) {
+        atingido[i] = nullptr;
+        impacto[i].distance = pacote.tMax[i];
+    }
+
+    if (CollisionKernels::level() != CollisionKernels::SCALAR) {
+        // Teste exato dos raios (bits de mask) que atravessam a caixa do candidato
+        broadPhase.queryPacket(pacote, [&](void* userData, unsigned int mask) {
+            Object3D* candidato = static_cast<Object3D*>(userData);
+            for (int i = 0; i < pacote.count; i++) {
+                if (!(mask & (1u << i))) continue;
+
+                RayHit hit;
+                if (candidato->rayIntersect(projeteis.previousPosition(slots[i]), projeteis.direction(slots[i]),
+                                            impacto[i].distance, hit)) {
+                    atingido[i] = candidato;    // triângulo mais próximo até agora: os próximos candidatos testam só até ele
+                    impacto[i] = hit;
                 }
-            } else {
-                ++sceneObject; // Nenhuma colisão, verifica o próximo objeto
             }
+        });
+    } else {
+        // sem SIMD o pacote não compensa: cada raio desce sozinho pela árvore
+        for (int i = 0; i < pacote.count; i++) {
+            atingido[i] = sweepSegment(projeteis.previousPosition(slots[i]), projeteis.direction(slots[i]),
+                                       pacote.tMax[i], impacto[i]);
         }
     }
-}
\ No newline at end of file
+}
+
+
+// Objeto mais próximo atingido pelo segmento origem + direcao * t, t em (0, percurso]
+Object3D* System::sweepSegment(const vec3& origem, const vec3& direcao, float percurso, RayHit& impacto) {
+    Object3D* atingido = nullptr;
+    impacto.distance = percurso;
+
+    broadPhase.querySegment(origem, origem + direcao * percurso, [&](void* userData) {
+        Object3D* candidato = static_cast<Object3D*>(userData);
+        RayHit hit;
+        if (candidato->rayIntersect(origem, direcao, impacto.distance, hit)) {
+            atingido = candidato;
+            impacto = hit;
+        }
+        return true;    // continua: outro candidato pode estar mais próximo
+    });
+
+    return atingido;
+}
+
+
+// Aplica o impacto ao projétil: elimina o objeto atingido ou reflete o projétil e continua varrendo o que
+// resta do percurso do quadro a partir do ponto de impacto, resolvendo vários rebotes no mesmo quadro
+// Retorna o objeto eliminado (já removido da cena), ou nullptr
+Object3D* System::resolveImpact(size_t projetil, vec3 origem, float percurso, Object3D* atingido, RayHit impacto) {
+    const int MAX_BOUNCES = 4;  // rebotes resolvidos por quadro (limita o custo em cantos fechados)
+
+    for (int rebote = 0; atingido; rebote++) {
+        if (atingido->isEliminable()) {
+            impactEliminations++;
+            if (!quietImpacts) { cout << "Objeto \"" << atingido->name << "\" eliminado!" << endl; }
+            removeSceneObject(atingido);
+            projeteis.release(projetil);
+            return atingido;
+        }
+
+        // Ponto de impacto no triângulo atingido; reflete pela normal geométrica (ver MeshBVH)
+        vec3 hitPoint = origem + projeteis.direction(projetil) * impacto.distance;
+        projeteis.reflect(projetil, impacto.normal);
+        impactBounces++;
+        if (!quietImpacts) { cout << "Tiro refletiu em \"" << atingido->name << "\"!" << endl; }
+
+        // O restante do percurso continua na nova direção, com um pequeno offset para evitar re-colisão
+        origem = hitPoint + impacto.normal * 0.01f;
+        percurso = rebote + 1 < MAX_BOUNCES ? percurso - impacto.distance : 0.0f;
+        atingido = percurso > 0.0f ? sweepSegment(origem, projeteis.direction(projetil), percurso, impacto) : nullptr;
+    }
+
+    projeteis.setPosition(projetil, origem + projeteis.direction(projetil) * percurso);
+    return nullptr;
+}
+
+
+// Remove o objeto da broad phase e da cena
+void System::removeSceneObject(Object3D* object) {
+    if (object->broadPhaseProxy >= 0) {
+        broadPhase.remove(object->broadPhaseProxy);
+        object->broadPhaseProxy = -1;
+    }
+
+    auto it = find_if(sceneObjects.begin(), sceneObjects.end(),
+                      [object](const unique_ptr<Object3D>& obj) { return obj.get() == object; });
+    if (it != sceneObjects.end()) { sceneObjects.erase(it); }
+}
@@ -1,4 +1,5 @@
 #include "Texture.h"
+#include "Profiler.h"
 #include <iostream>
 #include <stb_image.h>
 
@@ -6,45 +7,67 @@
 map<string, unsigned int> Texture::textureCache;
 
 
-// Função auxiliar privada para carregar textura do arquivo
-static unsigned int loadTextureFromFile(const string& path) {
+// O stb_image desta versão só tem a opção global de inversão vertical: ela é ligada uma vez, antes de main,
+// para que as threads de carregamento nunca a alterem enquanto outras decodificam
+// (stb_image carrega de cima para baixo, OpenGL espera de baixo para cima)
+static struct InverteImagens {
+    InverteImagens() { stbi_set_flip_vertically_on_load(true); }
+} inverteImagens;
 
-    unsigned int textureID;
 
-    glGenTextures(1, &textureID);
-    
-    // Inverte a imagem verticalmente ao carregar (stb_image carrega de cima para baixo, OpenGL espera de baixo para cima)
-    stbi_set_flip_vertically_on_load(true);
-    
-    int width, height, nrComponents;
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrComponents, 0);
-    
-    if (data) {
-        GLenum format = GL_RGB; // Formato padrão
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
-        
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        
-        stbi_image_free(data);
-        
-        return textureID;
-    } else {
+void TextureImage::PixelDeleter::operator()(unsigned char* pixels) const {
+    stbi_image_free(pixels);
+}
+
+
+// Lê e decodifica o arquivo de imagem (sem chamadas OpenGL)
+bool Texture::decode(const string& path, TextureImage& image) {
+    PROFILE_ZONE_DETAIL("Texture::decode", path);
+    image.pixels.reset(stbi_load(path.c_str(), &image.width, &image.height, &image.channels, 0));
+    if (!image.pixels) {
         cout << "Falha ao carregar textura: " << path << endl;
-        glDeleteTextures(1, &textureID);
-        return 0;
+        return false;
     }
+    return true;
+}
+
+
+// Cria a textura OpenGL a partir da imagem decodificada e a coloca no cache
+unsigned int Texture::upload(const string& path, TextureImage& image) {
+    PROFILE_ZONE_DETAIL("Texture::upload", path);
+    auto it = textureCache.find(path);
+    if (it != textureCache.end()) {
+        image.pixels.reset();
+        cout << "Textura recuperada do cache: " << path << " (ID: " << it->second << ")" << endl;
+        return it->second;
+    }
+
+    if (!image.pixels) { return 0; }
+
+    GLenum format = GL_RGB; // Formato padrão
+    if (image.channels == 1)
+        format = GL_RED;
+    else if (image.channels == 3)
+        format = GL_RGB;
+    else if (image.channels == 4)
+        format = GL_RGBA;
+
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels.get());
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    image.pixels.reset();   // a imagem agora está na GPU
+
+    textureCache[path] = textureID;
+    cout << "Textura carregada do arquivo: " << path << " (ID: " << textureID << ")" << endl;
+    return textureID;
 }
 
 
@@ -56,15 +79,12 @@ unsigned int Texture::loadTexture(const string& path) {
         // Textura encontrada! Reutilizar a textura existente
         cout << "Textura recuperada do cache: " << path << " (ID: " << it->second << ")" << endl;
         return it->second;  // retorna o ID da textura
-    } else {
-        // Textura não encontrada - carregar do disco e adicionar ao cache
-        unsigned int newTextureID = loadTextureFromFile(path);
-        if (newTextureID != 0) {
-            textureCache[path] = newTextureID;
-            cout << "Textura carregada do arquivo: " << path << " (ID: " << newTextureID << ")" << endl;
-        }
-        return newTextureID;
     }
+
+    // Textura não encontrada - carregar do disco e adicionar ao cache
+    TextureImage image;
+    if (!decode(path, image)) { return 0; }
+    return upload(path, image);
 }
 
 
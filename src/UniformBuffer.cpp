@@ -0,0 +1,58 @@
+#include "UniformBuffer.h"
+#include "RenderStats.h"
+
+
+UniformBuffer::UniformBuffer() : ID(0), size(0) {}
+
+
+UniformBuffer::~UniformBuffer() { cleanup(); }
+
+
+void UniformBuffer::create(size_t bufferSize, const void* data, GLenum usage) {
+    cleanup();
+    size = bufferSize;
+    glGenBuffers(1, &ID);
+    glBindBuffer(GL_UNIFORM_BUFFER, ID);
+    glBufferData(GL_UNIFORM_BUFFER, size, data, usage);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+
+void UniformBuffer::update(const void* data, size_t dataSize, size_t offset) const {
+    if (ID == 0) return;
+    glBindBuffer(GL_UNIFORM_BUFFER, ID);
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, dataSize, data);
+    RenderStats::stateChanges++;
+    RenderStats::uniformUploads++;
+}
+
+
+void UniformBuffer::bind(UniformBinding binding) const {
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, ID);
+    RenderStats::stateChanges++;
+}
+
+
+void UniformBuffer::bindRange(UniformBinding binding, size_t offset, size_t rangeSize) const {
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, ID, offset, rangeSize);
+    RenderStats::stateChanges++;
+}
+
+
+size_t UniformBuffer::offsetAlignment() {
+    static GLint alinhamento = 0;
+    if (alinhamento == 0) {
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alinhamento);
+        if (alinhamento <= 0) { alinhamento = 256; }   // maior valor comum entre os drivers
+    }
+    return (size_t)alinhamento;
+}
+
+
+void UniformBuffer::cleanup() {
+    if (ID != 0) {
+        glDeleteBuffers(1, &ID);
+        ID = 0;
+    }
+    size = 0;
+}